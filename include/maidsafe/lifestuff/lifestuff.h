@@ -19,9 +19,11 @@
 #ifndef MAIDSAFE_LIFESTUFF_LIFESTUFF_H_
 #define MAIDSAFE_LIFESTUFF_LIFESTUFF_H_
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <functional>
+#include <vector>
 
 namespace maidsafe {
 namespace lifestuff {
@@ -38,6 +40,25 @@ enum InputField {
   kCurrentPassword
 };
 
+// Operation applied by one UserInputEdit, see LifeStuff::ApplyUserInput.
+enum InputOperation {
+  kInsertInput = 0,
+  kRemoveInput,
+  kClearInput
+};
+
+// A single edit of a user input field: inserts 'characters' at 'position', removes 'length'
+// characters from 'position', or clears the field, depending on 'operation'.
+struct UserInputEdit {
+  UserInputEdit() : input_field(kKeyword), operation(kInsertInput), position(0), length(0),
+                    characters() {}
+  InputField input_field;
+  InputOperation operation;
+  uint32_t position;
+  uint32_t length;
+  std::string characters;
+};
+
 // Used in conjunction with ProgressCode to report execution state during various function calls
 // via the ReportProgressFunction function, see definition below.
 enum Action {
@@ -62,6 +83,22 @@ enum ProgressCode {
   kConfirmingUserInput
 };
 
+// Latency of one Action/ProgressCode phase, i.e. the time from its report to the next report in
+// the same call, aggregated over all calls made so far.  Percentiles are in microseconds.
+struct PhaseStatistics {
+  PhaseStatistics() : action(kCreateUser), progress_code(kInitialiseProcess), occurrence(0),
+                      failed(false), count(0), p50(0), p95(0), p99(0) {}
+  Action action;
+  ProgressCode progress_code;
+  // Distinguishes a progress code reported more than once in one call, e.g. 1 for the second
+  // kJoiningNetwork phase of LogIn.
+  uint32_t occurrence;
+  // Set for the phase during which a call failed; such samples are kept apart from successful ones.
+  bool failed;
+  uint64_t count;
+  int64_t p50, p95, p99;
+};
+
 // New version update.
 typedef std::function<void(const std::string&)> UpdateAvailableFunction;
 // Network health.
@@ -72,6 +109,9 @@ typedef std::function<void(bool)> OperationsPendingFunction;
 typedef std::function<void()> ConfigurationErrorFunction;
 // Associate storage location with drive directory.
 typedef std::function<void(const std::string&)> OnServiceAddedFunction;
+// A newer copy of the session than the locally cached one used to log in was found on the network
+// and has replaced it.  Invoked on the thread of the operation which applied it.  Optional.
+typedef std::function<void()> SessionChangedFunction;
 
 
 // Slots are used to provide useful information back to the client application.
@@ -81,6 +121,75 @@ struct Slots {
   OperationsPendingFunction operations_pending;
   ConfigurationErrorFunction configuration_error;
   OnServiceAddedFunction on_service_added;
+  SessionChangedFunction session_changed;
+};
+
+// Tuning for a LifeStuff instance.  The defaults suit an interactive client.
+struct ClientOptions {
+  ClientOptions()
+      : fob_pool_depth(1), executor_threads(0), executor_cpu_affinity(), racing_join(false),
+        bootstrap_cache_path(), public_key_cache_path() {}
+  // Number of passports whose RSA keys are generated ahead of CreateUser once PrepareCreateUser has
+  // been called.  Zero disables pre-generation.
+  uint32_t fob_pool_depth;
+  // Worker threads running routing callbacks and other short background tasks.  Zero means one per
+  // hardware thread.
+  uint32_t executor_threads;
+  // If not empty, worker i is pinned to CPU executor_cpu_affinity[i % size()].  Linux only.
+  std::vector<int> executor_cpu_affinity;
+  // If set, CreateUser and LogIn first bootstrap via several endpoints at once, under throwaway
+  // identities, and then join via whichever was fastest.  This costs extra joins, once per
+  // operation, so it only pays off when some bootstrap endpoints are slow or unreachable.
+  bool racing_join;
+  // Files in which bootstrap endpoints and other nodes' public keys are kept between runs.  Empty
+  // means the default location under the user's home directory.  Clients sharing a file merge
+  // their entries with it when saving rather than overwriting each other's.
+  std::string bootstrap_cache_path, public_key_cache_path;
+};
+
+// Load on the worker threads configured by ClientOptions::executor_threads.  Times are in
+// microseconds.
+struct ExecutorStatistics {
+  ExecutorStatistics() : thread_count(0), queue_depth(0), max_queue_depth(0), completed(0),
+                         total_wait(0), max_wait(0), total_run(0) {}
+  uint32_t thread_count;
+  // Tasks posted but not yet started.
+  uint64_t queue_depth, max_queue_depth;
+  uint64_t completed;
+  // Queueing delay and execution time of completed tasks.
+  uint64_t total_wait, max_wait, total_run;
+};
+
+// How the CreateUser calls made so far obtained their RSA keys, see ClientOptions::fob_pool_depth.
+struct FobPoolStatistics {
+  FobPoolStatistics() : hits(0), waits(0), misses(0), ready(0) {}
+  // Keys which were ready, keys which were still being generated in the background and were waited
+  // for, and keys generated on the calling thread, respectively.
+  uint64_t hits, waits, misses;
+  // Sets of keys ready for the next CreateUser.
+  uint32_t ready;
+};
+
+// An in-process simulation of the network for offline benchmarks and load tests, see
+// LifeStuff::UseLoopbackNetwork.
+struct LoopbackNetworkOptions {
+  LoopbackNetworkOptions()
+      : hops(1), hop_latency(0), hop_jitter(0), bandwidth(0), loss(0.0), timeout(1000), seed(0) {}
+  // Hops taken by each message in each direction, e.g. to reach the close group of the data.
+  uint32_t hops;
+  // Each hop takes 'hop_latency' plus a uniformly distributed extra delay of up to 'hop_jitter'.
+  std::chrono::microseconds hop_latency, hop_jitter;
+  // Bytes per second through the client's link in each direction, shared by concurrent requests.
+  // Zero means unlimited.
+  uint64_t bandwidth;
+  // Probability in [0, 1] that any one message is lost.  A request whose request or response is
+  // lost throws CommonErrors::unable_to_handle_request once 'timeout' has passed since it started.
+  double loss;
+  std::chrono::milliseconds timeout;
+  // The jitter and loss of a request depend only on this seed, the request's type and name, and
+  // how many requests of that type and name came before it, so runs are reproducible however
+  // concurrent requests interleave.  Queueing for limited bandwidth is not.
+  uint32_t seed;
 };
 
 // Some methods may take some time to complete, e.g. Login. The ReportProgressFunction is used to
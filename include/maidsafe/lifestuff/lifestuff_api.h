@@ -19,7 +19,11 @@
 #ifndef MAIDSAFE_LIFESTUFF_LIFESTUFF_API_H_
 #define MAIDSAFE_LIFESTUFF_LIFESTUFF_API_H_
 
+#include <future>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "maidsafe/lifestuff/lifestuff.h"
 
@@ -38,9 +42,9 @@ namespace lifestuff {
 
 class LifeStuff {
  public:
-  // LifeStuff constructor, refer to discussion in lifestuff.h for Slots. Throws
+  // LifeStuff constructor, refer to discussion in lifestuff.h for Slots and ClientOptions. Throws
   // CommonErrors::uninitialised if any 'slots' member has not been initialised.
-  explicit LifeStuff(const Slots& slots);
+  explicit LifeStuff(const Slots& slots, const ClientOptions& options = ClientOptions());
   ~LifeStuff();
 
   // Note: Secure string classes for managing user input are provided by the input types Keyword,
@@ -54,13 +58,35 @@ class LifeStuff {
   // definition of InputField. Implicitly accepts Unicode characters converted to std::string.
   void InsertUserInput(uint32_t position, const std::string& characters, InputField input_field);
   // Removes the sequence of characters starting at position 'position' and ending at position
-  // 'position' + 'length' from the input type determined by 'input_field'.
+  // 'position' + 'length' from the input type determined by 'input_field'.  Throws
+  // CommonErrors::invalid_parameter if that range extends past the end of the input.
   void RemoveUserInput(uint32_t position, uint32_t length, InputField input_field);
   // Clears the currently inserted characters from the input type determined by 'input_field'.
   void ClearUserInput(InputField input_field);
   // Compares input types, dependent on 'input_field' value, for equality.
   bool ConfirmUserInput(InputField input_field);
 
+  // Applies 'edits' in order, as the equivalent Insert/Remove/ClearUserInput calls would.  All
+  // edits, including the positions and lengths of removals, are validated against the input as
+  // left by the preceding edits before any is applied, so an invalid batch throws
+  // CommonErrors::invalid_parameter (or uninitialised) and leaves the input unchanged.  Should an
+  // edit nevertheless fail while being applied, every field touched by the batch is cleared before
+  // the exception is propagated.
+  void ApplyUserInput(const std::vector<UserInputEdit>& edits);
+  // Replaces the keyword, pin and password in one call, e.g. for automated flows which have the
+  // complete credentials up front.  Throws CommonErrors::invalid_parameter, leaving the input
+  // unchanged, if any of them contains invalid characters.
+  void SetCredentials(const std::string& keyword,
+                      const std::string& pin,
+                      const std::string& password);
+  // Returns the result of ConfirmUserInput for every field which currently has input.
+  // kCurrentPassword is only included once logged in.
+  std::map<InputField, bool> ConfirmAllUserInput();
+
+  // Optional: starts generating the RSA keys for a new account in the background, see
+  // ClientOptions::fob_pool_depth, so that a following CreateUser need not wait for them.  Call it
+  // e.g. when the account creation form is shown; clients which only log in never should.
+  void PrepareCreateUser();
   // Creates new user credentials, derived from input keyword, pin and password, that are
   // subsequently retrieved from the network during login. Also sets up a new vault associated
   // with those credentials. Refer to details in lifestuff.h about ReportProgressFunction.
@@ -70,6 +96,17 @@ class LifeStuff {
   // starts the appropriate vault. Refer to details in lifestuff.h about ReportProgressFunction.
   // If an exception is thrown during the call, attempts cleanup then rethrows the exception.
   void LogIn(const std::string& storage_path, ReportProgressFunction& report_progress);
+  // For offline benchmarks and load tests only: serves all network operations and vault start-up
+  // from an in-process simulation, see LoopbackNetworkOptions in lifestuff.h, instead of the real
+  // network.  The virtual drive is not simulated, so CreateUser skips its drive check and
+  // MountDrive throws.  Must be called before CreateUser or LogIn.
+  void UseLoopbackNetwork(const LoopbackNetworkOptions& options);
+  // Opt-in: keeps a copy of the encrypted session on this machine, under kAppHomeDirectory, so that
+  // subsequent logins can decrypt it locally instead of retrieving it from the network first.  The
+  // network copy is then checked in the background and, if newer, replaces the local one before
+  // the next operation, with Slots::session_changed invoked if set.  Waits for any background
+  // session work in progress before switching.
+  void EnableSessionCache(bool enable);
   // Stops the vault associated with the session and unmounts the virtual drive where applicable.
   void LogOut();
 
@@ -83,9 +120,46 @@ class LifeStuff {
   void ChangePin(ReportProgressFunction& report_progress);
   void ChangePassword(ReportProgressFunction& report_progress);
 
+  // Non-blocking variants of the above operations.  Each call is queued and executed on an
+  // internal thread, one operation at a time in submission order, and returns a future which
+  // becomes ready when the operation completes or rethrows any exception it raised.
+  // 'report_progress' is copied and invoked on the internal thread.  The user input an operation
+  // consumes is copied and cleared when it is queued, so it may be edited again straight away.
+  // The blocking forms of these operations, UseLoopbackNetwork and EnableSessionCache are queued in
+  // the same way and wait for their turn, so they too invoke 'report_progress' on the internal
+  // thread.  Calling any of them from there would deadlock, so throws.
+  std::future<void> CreateUserAsync(const std::string& storage_path,
+                                    const ReportProgressFunction& report_progress);
+  std::future<void> LogInAsync(const std::string& storage_path,
+                               const ReportProgressFunction& report_progress);
+  std::future<void> LogOutAsync();
+  std::future<void> MountDriveAsync();
+  std::future<void> UnMountDriveAsync();
+  std::future<void> ChangeKeywordAsync(const ReportProgressFunction& report_progress);
+  std::future<void> ChangePinAsync(const ReportProgressFunction& report_progress);
+  std::future<void> ChangePasswordAsync(const ReportProgressFunction& report_progress);
+
   // Returns whether user is logged in or not.
   bool logged_in() const;
 
+  // Per-phase latency percentiles for the CreateUser, LogIn and Change* operations performed so
+  // far, see PhaseStatistics in lifestuff.h.
+  std::vector<PhaseStatistics> GetPhaseStatistics() const;
+  // Load on the worker threads running routing callbacks, see ExecutorStatistics in lifestuff.h.
+  ExecutorStatistics GetExecutorStatistics() const;
+  // Effectiveness of PrepareCreateUser's key pre-generation, see FobPoolStatistics in lifestuff.h.
+  FobPoolStatistics GetFobPoolStatistics() const;
+  // Writes the statistics above to 'file_path' as comma-separated values.  Throws
+  // CommonErrors::filesystem_io_error if the file cannot be written.
+  void WritePhaseStatistics(const std::string& file_path) const;
+
+  // Process-wide tracing of login, account creation, drive mount and network callback activity.
+  // Disabled by default.  WriteTrace outputs the most recent events on every thread in Chrome
+  // trace event JSON format, viewable in chrome://tracing or Perfetto.  Throws
+  // CommonErrors::filesystem_io_error if the file cannot be written.
+  static void EnableTracing(bool enable);
+  static void WriteTrace(const std::string& file_path);
+
   // Root path of mounted virtual drive or empty if unmounted.
   std::string mount_path();
   // Owner directory on mounted virtual drive or invalid if unmounted.
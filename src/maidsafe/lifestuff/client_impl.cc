@@ -18,10 +18,26 @@
 
 #include "maidsafe/lifestuff/client_impl.h"
 
+#include "maidsafe/lifestuff/detail/loopback_network.h"
+
 namespace maidsafe {
 namespace lifestuff {
 
-ClientImpl::ClientImpl(const Slots& slots)
+namespace {
+
+// Returns a finalised copy of 'input', or null if there is none.
+template<typename Input>
+std::unique_ptr<Input> CopyInput(const std::unique_ptr<Input>& input) {
+  if (!input)
+    return nullptr;
+  if (!input->IsFinalised())
+    input->Finalise();
+  return std::unique_ptr<Input>(new Input(input->string()));
+}
+
+}  // unnamed namespace
+
+ClientImpl::ClientImpl(const Slots& slots, const ClientOptions& options)
   : logged_in_(false),
     keyword_(),
     confirmation_keyword_(),
@@ -30,34 +46,65 @@ ClientImpl::ClientImpl(const Slots& slots)
     password_(),
     confirmation_password_(),
     current_password_(),
+    input_sizes_(),
     session_(),
-    client_maid_(session_, slots),
-    client_mpid_() {}
+    client_maid_(session_, slots, options),
+    client_mpid_(),
+    asio_service_(1),
+    worker_thread_id_() {
+  asio_service_.Start();
+  Post([this] { worker_thread_id_ = std::this_thread::get_id(); }).get();
+}
+
+ClientImpl::~ClientImpl() {
+  asio_service_.Stop();
+}
 
-ClientImpl::~ClientImpl() {}
+template<typename Functor>
+std::future<void> ClientImpl::Post(Functor functor) {
+  // asio requires copyable handlers, so the task is shared rather than moved in.
+  std::shared_ptr<std::packaged_task<void()>> task(
+      std::make_shared<std::packaged_task<void()>>(functor));
+  std::future<void> future(task->get_future());
+  asio_service_.service().post([task] { (*task)(); });
+  return future;
+}
+
+template<typename Functor>
+void ClientImpl::Run(Functor functor) {
+  // Run from the worker thread, e.g. from a 'report_progress' of a queued operation, this would
+  // wait forever for itself.
+  if (std::this_thread::get_id() == worker_thread_id_) {
+    LOG(kError) << "Blocking LifeStuff call made from within an operation's callback.";
+    ThrowError(CommonErrors::unable_to_handle_request);
+  }
+  Post(functor).get();
+}
 
 void ClientImpl::InsertUserInput(uint32_t position, const std::string& characters, InputField input_field) {
+  uint32_t& size(input_sizes_[input_field]);
   switch (input_field) {
     case kKeyword: {
-      return detail::InsertUserInput<Keyword>()(keyword_, position, characters);
+      return detail::InsertUserInput<Keyword>()(keyword_, size, position, characters);
     }
     case kPin: {
-      return detail::InsertUserInput<Pin>()(pin_, position, characters);
+      return detail::InsertUserInput<Pin>()(pin_, size, position, characters);
     }
     case kPassword: {
-      return detail::InsertUserInput<Password>()(password_, position, characters);
+      return detail::InsertUserInput<Password>()(password_, size, position, characters);
     }
     case kConfirmationKeyword: {
-      return detail::InsertUserInput<Keyword>()(confirmation_keyword_, position, characters);
+      return detail::InsertUserInput<Keyword>()(confirmation_keyword_, size, position, characters);
     }
     case kConfirmationPin: {
-      return detail::InsertUserInput<Pin>()(confirmation_pin_, position, characters);
+      return detail::InsertUserInput<Pin>()(confirmation_pin_, size, position, characters);
     }
     case kConfirmationPassword: {
-      return detail::InsertUserInput<Password>()(confirmation_password_, position, characters);
+      return detail::InsertUserInput<Password>()(confirmation_password_, size, position,
+                                                 characters);
     }
     case kCurrentPassword: {
-      return detail::InsertUserInput<Password>()(current_password_, position, characters);
+      return detail::InsertUserInput<Password>()(current_password_, size, position, characters);
     }
     default:
       ThrowError(CommonErrors::unknown);
@@ -66,27 +113,28 @@ void ClientImpl::InsertUserInput(uint32_t position, const std::string& character
 }
 
 void ClientImpl::RemoveUserInput(uint32_t position, uint32_t length, InputField input_field) {
+  uint32_t& size(input_sizes_[input_field]);
   switch (input_field) {
     case kKeyword: {
-      return detail::RemoveUserInput<Keyword>()(keyword_, position, length);
+      return detail::RemoveUserInput<Keyword>()(keyword_, size, position, length);
     }
     case kPin: {
-      return detail::RemoveUserInput<Pin>()(pin_, position, length);
+      return detail::RemoveUserInput<Pin>()(pin_, size, position, length);
     }
     case kPassword: {
-      return detail::RemoveUserInput<Password>()(password_, position, length);
+      return detail::RemoveUserInput<Password>()(password_, size, position, length);
     }
     case kConfirmationKeyword: {
-      return detail::RemoveUserInput<Keyword>()(confirmation_keyword_, position, length);
+      return detail::RemoveUserInput<Keyword>()(confirmation_keyword_, size, position, length);
     }
     case kConfirmationPin: {
-      return detail::RemoveUserInput<Pin>()(confirmation_pin_, position, length);
+      return detail::RemoveUserInput<Pin>()(confirmation_pin_, size, position, length);
     }
     case kConfirmationPassword: {
-      return detail::RemoveUserInput<Password>()(confirmation_password_, position, length);
+      return detail::RemoveUserInput<Password>()(confirmation_password_, size, position, length);
     }
     case kCurrentPassword: {
-      return detail::RemoveUserInput<Password>()(current_password_, position, length);
+      return detail::RemoveUserInput<Password>()(current_password_, size, position, length);
     }
     default:
       ThrowError(CommonErrors::unknown);
@@ -95,27 +143,28 @@ void ClientImpl::RemoveUserInput(uint32_t position, uint32_t length, InputField
 }
 
 void ClientImpl::ClearUserInput(InputField input_field) {
+  uint32_t& size(input_sizes_[input_field]);
   switch (input_field) {
     case kKeyword: {
-      return detail::ClearUserInput<Keyword>()(keyword_);
+      return detail::ClearUserInput<Keyword>()(keyword_, size);
     }
     case kPin: {
-      return detail::ClearUserInput<Pin>()(pin_);
+      return detail::ClearUserInput<Pin>()(pin_, size);
     }
     case kPassword: {
-      return detail::ClearUserInput<Password>()(password_);
+      return detail::ClearUserInput<Password>()(password_, size);
     }
     case kConfirmationKeyword: {
-      return detail::ClearUserInput<Keyword>()(confirmation_keyword_);
+      return detail::ClearUserInput<Keyword>()(confirmation_keyword_, size);
     }
     case kConfirmationPin: {
-      return detail::ClearUserInput<Pin>()(confirmation_pin_);
+      return detail::ClearUserInput<Pin>()(confirmation_pin_, size);
     }
     case kConfirmationPassword: {
-      return detail::ClearUserInput<Password>()(confirmation_password_);
+      return detail::ClearUserInput<Password>()(confirmation_password_, size);
     }
     case kCurrentPassword: {
-      return detail::ClearUserInput<Password>()(current_password_);
+      return detail::ClearUserInput<Password>()(current_password_, size);
     }
     default:
       ThrowError(CommonErrors::unknown);
@@ -152,82 +201,274 @@ bool ClientImpl::ConfirmUserInput(InputField input_field) {
   return false;
 }
 
+void ClientImpl::ApplyUserInput(const std::vector<UserInputEdit>& edits) {
+  std::map<InputField, uint32_t> sizes;
+  for (auto& edit : edits)
+    ValidateUserInputEdit(edit, sizes);
+
+  std::set<InputField> touched;
+  try {
+    for (auto& edit : edits) {
+      touched.insert(edit.input_field);
+      switch (edit.operation) {
+        case kInsertInput:
+          InsertUserInput(edit.position, edit.characters, edit.input_field);
+          break;
+        case kRemoveInput:
+          RemoveUserInput(edit.position, edit.length, edit.input_field);
+          break;
+        default:
+          ClearUserInput(edit.input_field);
+      }
+    }
+  }
+  catch(const std::exception& e) {
+    LOG(kError) << "Failed to apply user input edit: " << e.what();
+    for (auto input_field : touched)
+      ClearUserInput(input_field);
+    throw;
+  }
+}
+
+void ClientImpl::SetCredentials(const std::string& keyword,
+                                const std::string& pin,
+                                const std::string& password) {
+  if (!detail::IsValidInsertion<Keyword>(0, 0, keyword) ||
+      !detail::IsValidInsertion<Pin>(0, 0, pin) ||
+      !detail::IsValidInsertion<Password>(0, 0, password))
+    ThrowError(CommonErrors::invalid_parameter);
+  keyword_.reset();
+  pin_.reset();
+  password_.reset();
+  detail::InsertUserInput<Keyword>()(keyword_, input_sizes_[kKeyword], 0, keyword);
+  detail::InsertUserInput<Pin>()(pin_, input_sizes_[kPin], 0, pin);
+  detail::InsertUserInput<Password>()(password_, input_sizes_[kPassword], 0, password);
+}
+
+std::map<InputField, bool> ClientImpl::ConfirmAllUserInput() {
+  std::map<InputField, bool> results;
+  const InputField kInputFields[] = { kPin, kKeyword, kPassword, kConfirmationPin,
+                                      kConfirmationKeyword, kConfirmationPassword,
+                                      kCurrentPassword };
+  for (auto input_field : kInputFields) {
+    if (!HasUserInput(input_field) || (input_field == kCurrentPassword && !logged_in_))
+      continue;
+    results[input_field] = ConfirmUserInput(input_field);
+  }
+  return results;
+}
+
+void ClientImpl::PrepareCreateUser() {
+  client_maid_.PrepareCreateUser();
+}
+
 void ClientImpl::CreateUser(const boost::filesystem::path& storage_path,
-                                     ReportProgressFunction& report_progress) {
-  FinaliseUserInput();
+                            ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
   ResetConfirmationInput();
-  client_maid_.CreateUser(*keyword_, *pin_, *password_, storage_path, report_progress);
+  Run([&] { CreateUser(*credentials, storage_path, report_progress); });
   ResetInput();
-  logged_in_ = true;
-  return;
 }
 
 void ClientImpl::LogIn(const boost::filesystem::path& storage_path,
-                                ReportProgressFunction& report_progress) {
-  FinaliseUserInput();
-  client_maid_.LogIn(*keyword_, *pin_, *password_, storage_path, report_progress);
+                       ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  Run([&] { LogIn(*credentials, storage_path, report_progress); });
   ResetInput();
-  logged_in_ = true;
-  return;
+}
+
+void ClientImpl::UseLoopbackNetwork(const LoopbackNetworkOptions& options) {
+  Run([&] { client_maid_.UseNetwork(std::make_shared<LoopbackNetwork>(options)); });
+}
+
+void ClientImpl::EnableSessionCache(bool enable) {
+  Run([&] { client_maid_.EnableSessionCache(enable); });
 }
 
 void ClientImpl::LogOut() {
-  client_maid_.LogOut();
+  Run([this] { client_maid_.LogOut(); });
 }
 
 void ClientImpl::MountDrive() {
-  client_maid_.MountDrive();
+  Run([this] { client_maid_.MountDrive(); });
 }
 
 void ClientImpl::UnMountDrive() {
-  client_maid_.UnMountDrive();
+  Run([this] { client_maid_.UnMountDrive(); });
 }
 
 void ClientImpl::ChangeKeyword(ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  Run([&] { ChangeKeyword(*credentials, report_progress); });
+  keyword_.reset();
+  confirmation_keyword_.reset();
+  current_password_.reset();
+}
+
+void ClientImpl::ChangePin(ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  Run([&] { ChangePin(*credentials, report_progress); });
+  pin_.reset();
+  confirmation_pin_.reset();
+  current_password_.reset();
+}
+
+void ClientImpl::ChangePassword(ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  Run([&] { ChangePassword(*credentials, report_progress); });
+  password_.reset();
+  confirmation_password_.reset();
+  current_password_.reset();
+}
+
+void ClientImpl::CreateUser(Credentials& credentials,
+                            const boost::filesystem::path& storage_path,
+                            ReportProgressFunction& report_progress) {
+  if (!credentials.keyword || !credentials.pin || !credentials.password)
+    ThrowError(CommonErrors::uninitialised);
+  client_maid_.CreateUser(*credentials.keyword, *credentials.pin, *credentials.password,
+                          storage_path, report_progress);
+  logged_in_ = true;
+}
+
+void ClientImpl::LogIn(Credentials& credentials,
+                       const boost::filesystem::path& storage_path,
+                       ReportProgressFunction& report_progress) {
+  if (!credentials.keyword || !credentials.pin || !credentials.password)
+    ThrowError(CommonErrors::uninitialised);
+  client_maid_.LogIn(*credentials.keyword, *credentials.pin, *credentials.password, storage_path,
+                     report_progress);
+  logged_in_ = true;
+}
+
+void ClientImpl::ChangeKeyword(Credentials& credentials,
+                               ReportProgressFunction& report_progress) {
   report_progress(kChangeKeyword, kConfirmingUserInput);
-  if (!ConfirmUserInput(kCurrentPassword))
+  if (!ConfirmCurrentPassword(credentials) || !credentials.keyword)
     ThrowError(CommonErrors::invalid_parameter);
   client_maid_.ChangeKeyword(session_.keyword(),
-                             *keyword_,
+                             *credentials.keyword,
                              session_.pin(),
                              session_.password(),
                              report_progress);
-  keyword_.reset();
-  confirmation_keyword_.reset();
-  current_password_.reset();
-  return;
 }
 
-void ClientImpl::ChangePin(ReportProgressFunction& report_progress) {
+void ClientImpl::ChangePin(Credentials& credentials, ReportProgressFunction& report_progress) {
   report_progress(kChangePin, kConfirmingUserInput);
-  if (!ConfirmUserInput(kCurrentPassword))
+  if (!ConfirmCurrentPassword(credentials) || !credentials.pin)
     ThrowError(CommonErrors::invalid_parameter);
   client_maid_.ChangePin(session_.keyword(),
                          session_.pin(),
-                         *pin_,
+                         *credentials.pin,
                          session_.password(),
                          report_progress);
+}
+
+void ClientImpl::ChangePassword(Credentials& credentials,
+                                ReportProgressFunction& report_progress) {
+  report_progress(kChangePassword, kConfirmingUserInput);
+  if (!ConfirmCurrentPassword(credentials) || !credentials.password)
+    ThrowError(CommonErrors::invalid_parameter);
+  client_maid_.ChangePassword(session_.keyword(), session_.pin(), *credentials.password,
+                              report_progress);
+}
+
+std::future<void> ClientImpl::CreateUserAsync(const boost::filesystem::path& storage_path,
+                                              const ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  ResetConfirmationInput();
+  ResetInput();
+  return Post([this, credentials, storage_path, report_progress]() mutable {
+                CreateUser(*credentials, storage_path, report_progress);
+              });
+}
+
+std::future<void> ClientImpl::LogInAsync(const boost::filesystem::path& storage_path,
+                                         const ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  ResetInput();
+  return Post([this, credentials, storage_path, report_progress]() mutable {
+                LogIn(*credentials, storage_path, report_progress);
+              });
+}
+
+std::future<void> ClientImpl::LogOutAsync() {
+  return Post([this] { client_maid_.LogOut(); });
+}
+
+std::future<void> ClientImpl::MountDriveAsync() {
+  return Post([this] { client_maid_.MountDrive(); });
+}
+
+std::future<void> ClientImpl::UnMountDriveAsync() {
+  return Post([this] { client_maid_.UnMountDrive(); });
+}
+
+std::future<void> ClientImpl::ChangeKeywordAsync(const ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
+  keyword_.reset();
+  confirmation_keyword_.reset();
+  current_password_.reset();
+  return Post([this, credentials, report_progress]() mutable {
+                ChangeKeyword(*credentials, report_progress);
+              });
+}
+
+std::future<void> ClientImpl::ChangePinAsync(const ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
   pin_.reset();
   confirmation_pin_.reset();
   current_password_.reset();
-  return;
+  return Post([this, credentials, report_progress]() mutable {
+                ChangePin(*credentials, report_progress);
+              });
 }
 
-void ClientImpl::ChangePassword(ReportProgressFunction& report_progress) {
-  report_progress(kChangePassword, kConfirmingUserInput);
-  if (!ConfirmUserInput(kCurrentPassword))
-    ThrowError(CommonErrors::invalid_parameter);
-  client_maid_.ChangePassword(session_.keyword(), session_.pin(), *password_, report_progress);
+std::future<void> ClientImpl::ChangePasswordAsync(const ReportProgressFunction& report_progress) {
+  CredentialsPtr credentials(CopyCredentials());
   password_.reset();
   confirmation_password_.reset();
   current_password_.reset();
-  return;
+  return Post([this, credentials, report_progress]() mutable {
+                ChangePassword(*credentials, report_progress);
+              });
 }
 
 bool ClientImpl::logged_in() const {
   return logged_in_;
 }
 
+std::vector<PhaseStatistics> ClientImpl::GetPhaseStatistics() const {
+  return client_maid_.phase_recorder().Statistics();
+}
+
+ExecutorStatistics ClientImpl::GetExecutorStatistics() const {
+  Executor::Metrics metrics(client_maid_.executor().metrics());
+  ExecutorStatistics statistics;
+  statistics.thread_count = metrics.thread_count;
+  statistics.queue_depth = metrics.queue_depth;
+  statistics.max_queue_depth = metrics.max_queue_depth;
+  statistics.completed = metrics.completed;
+  statistics.total_wait = metrics.total_wait;
+  statistics.max_wait = metrics.max_wait;
+  statistics.total_run = metrics.total_run;
+  return statistics;
+}
+
+FobPoolStatistics ClientImpl::GetFobPoolStatistics() const {
+  FobPool::Metrics metrics(client_maid_.fob_pool_metrics());
+  FobPoolStatistics statistics;
+  statistics.hits = metrics.hits;
+  statistics.waits = metrics.waits;
+  statistics.misses = metrics.misses;
+  statistics.ready = static_cast<uint32_t>(metrics.ready);
+  return statistics;
+}
+
+void ClientImpl::WritePhaseStatistics(const boost::filesystem::path& file_path) const {
+  client_maid_.phase_recorder().WriteToFile(file_path);
+}
+
 boost::filesystem::path ClientImpl::mount_path() {
   return client_maid_.mount_path();
 }
@@ -236,11 +477,100 @@ boost::filesystem::path ClientImpl::owner_path() {
   return client_maid_.owner_path();
 }
 
-void ClientImpl::FinaliseUserInput() {
-  keyword_->Finalise();
-  pin_->Finalise();
-  password_->Finalise();
-  return;
+void ClientImpl::ValidateUserInputEdit(const UserInputEdit& edit,
+                                       std::map<InputField, uint32_t>& sizes) const {
+  // 'sizes' holds the size of each field as left by the edits validated so far, and lacks fields
+  // which have no input yet.
+  if (sizes.count(edit.input_field) == 0 && HasUserInput(edit.input_field))
+    sizes[edit.input_field] = UserInputSize(edit.input_field);
+  switch (edit.operation) {
+    case kInsertInput: {
+      uint32_t size(sizes.count(edit.input_field) == 0 ? 0 : sizes[edit.input_field]);
+      bool valid(false);
+      switch (edit.input_field) {
+        case kKeyword:
+        case kConfirmationKeyword:
+          valid = detail::IsValidInsertion<Keyword>(size, edit.position, edit.characters);
+          break;
+        case kPin:
+        case kConfirmationPin:
+          valid = detail::IsValidInsertion<Pin>(size, edit.position, edit.characters);
+          break;
+        case kPassword:
+        case kConfirmationPassword:
+        case kCurrentPassword:
+          valid = detail::IsValidInsertion<Password>(size, edit.position, edit.characters);
+          break;
+        default:
+          ThrowError(CommonErrors::unknown);
+      }
+      if (!valid)
+        ThrowError(CommonErrors::invalid_parameter);
+      sizes[edit.input_field] = size + static_cast<uint32_t>(edit.characters.size());
+      break;
+    }
+    case kRemoveInput: {
+      if (sizes.count(edit.input_field) == 0)
+        ThrowError(CommonErrors::uninitialised);
+      uint32_t& size(sizes[edit.input_field]);
+      if (!detail::IsValidRemoval(size, edit.position, edit.length))
+        ThrowError(CommonErrors::invalid_parameter);
+      size -= edit.length;
+      break;
+    }
+    case kClearInput:
+      if (sizes.count(edit.input_field) != 0)
+        sizes[edit.input_field] = 0;
+      break;
+    default:
+      ThrowError(CommonErrors::invalid_parameter);
+  }
+}
+
+uint32_t ClientImpl::UserInputSize(InputField input_field) const {
+  if (!HasUserInput(input_field))
+    return 0;
+  auto itr(input_sizes_.find(input_field));
+  return itr == input_sizes_.end() ? 0 : itr->second;
+}
+
+bool ClientImpl::HasUserInput(InputField input_field) const {
+  switch (input_field) {
+    case kKeyword:
+      return keyword_ != nullptr;
+    case kPin:
+      return pin_ != nullptr;
+    case kPassword:
+      return password_ != nullptr;
+    case kConfirmationKeyword:
+      return confirmation_keyword_ != nullptr;
+    case kConfirmationPin:
+      return confirmation_pin_ != nullptr;
+    case kConfirmationPassword:
+      return confirmation_password_ != nullptr;
+    case kCurrentPassword:
+      return current_password_ != nullptr;
+    default:
+      ThrowError(CommonErrors::unknown);
+  }
+  return false;
+}
+
+ClientImpl::CredentialsPtr ClientImpl::CopyCredentials() {
+  CredentialsPtr credentials(std::make_shared<Credentials>());
+  credentials->keyword = CopyInput(keyword_);
+  credentials->pin = CopyInput(pin_);
+  credentials->password = CopyInput(password_);
+  credentials->confirmation_password = CopyInput(confirmation_password_);
+  credentials->current_password = CopyInput(current_password_);
+  return credentials;
+}
+
+bool ClientImpl::ConfirmCurrentPassword(Credentials& credentials) const {
+  return detail::ConfirmUserInput<Password>()(credentials.password,
+                                              credentials.confirmation_password,
+                                              credentials.current_password,
+                                              session_);
 }
 
 void ClientImpl::ResetInput() {
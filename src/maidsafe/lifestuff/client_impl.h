@@ -19,8 +19,19 @@
 #ifndef MAIDSAFE_LIFESTUFF_CLIENT_IMPL_H_
 #define MAIDSAFE_LIFESTUFF_CLIENT_IMPL_H_
 
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/asio_service.h"
+
 #include "maidsafe/lifestuff/lifestuff.h"
 #include "maidsafe/lifestuff/detail/client_maid.h"
 #include "maidsafe/lifestuff/detail/client_mpid.h"
@@ -30,16 +41,24 @@ namespace lifestuff {
 
 class ClientImpl {
  public:
-  explicit ClientImpl(const Slots& slots);
+  ClientImpl(const Slots& slots, const ClientOptions& options);
   ~ClientImpl();
 
   void InsertUserInput(uint32_t position, const std::string& characters, InputField input_field);
   void RemoveUserInput(uint32_t position, uint32_t length, InputField input_field);
   void ClearUserInput(InputField input_field);
   bool ConfirmUserInput(InputField input_field);
+  void ApplyUserInput(const std::vector<UserInputEdit>& edits);
+  void SetCredentials(const std::string& keyword,
+                      const std::string& pin,
+                      const std::string& password);
+  std::map<InputField, bool> ConfirmAllUserInput();
 
+  void PrepareCreateUser();
   void CreateUser(const boost::filesystem::path& storage_path, ReportProgressFunction& report_progress);
   void LogIn(const boost::filesystem::path& storage_path, ReportProgressFunction& report_progress);
+  void UseLoopbackNetwork(const LoopbackNetworkOptions& options);
+  void EnableSessionCache(bool enable);
   void LogOut();
   void MountDrive();
   void UnMountDrive();
@@ -48,25 +67,78 @@ class ClientImpl {
   void ChangePin(ReportProgressFunction& report_progress);
   void ChangePassword(ReportProgressFunction& report_progress);
 
+  // Asynchronous variants of the above.  Operations are queued on an internal executor and run one
+  // at a time in the order they were submitted; any exception is stored in the returned future.
+  // The blocking operations above are queued the same way and wait for their turn, so the two may
+  // be mixed freely.
+  std::future<void> CreateUserAsync(const boost::filesystem::path& storage_path,
+                                    const ReportProgressFunction& report_progress);
+  std::future<void> LogInAsync(const boost::filesystem::path& storage_path,
+                               const ReportProgressFunction& report_progress);
+  std::future<void> LogOutAsync();
+  std::future<void> MountDriveAsync();
+  std::future<void> UnMountDriveAsync();
+  std::future<void> ChangeKeywordAsync(const ReportProgressFunction& report_progress);
+  std::future<void> ChangePinAsync(const ReportProgressFunction& report_progress);
+  std::future<void> ChangePasswordAsync(const ReportProgressFunction& report_progress);
+
   bool logged_in() const;
 
+  std::vector<PhaseStatistics> GetPhaseStatistics() const;
+  ExecutorStatistics GetExecutorStatistics() const;
+  FobPoolStatistics GetFobPoolStatistics() const;
+  void WritePhaseStatistics(const boost::filesystem::path& file_path) const;
+
   boost::filesystem::path mount_path();
   boost::filesystem::path owner_path();
 
   void CreatePublicId(const NonEmptyString& public_id);
 
  private:
-  void FinaliseUserInput();
+  // Finalised copies of the input which the credential operations consume.  Asynchronous
+  // operations take theirs when queued, so the worker thread never reads the live input.
+  struct Credentials {
+    std::unique_ptr<Keyword> keyword;
+    std::unique_ptr<Pin> pin;
+    std::unique_ptr<Password> password, confirmation_password, current_password;
+  };
+  typedef std::shared_ptr<Credentials> CredentialsPtr;
+
+  void CreateUser(Credentials& credentials,
+                  const boost::filesystem::path& storage_path,
+                  ReportProgressFunction& report_progress);
+  void LogIn(Credentials& credentials,
+             const boost::filesystem::path& storage_path,
+             ReportProgressFunction& report_progress);
+  void ChangeKeyword(Credentials& credentials, ReportProgressFunction& report_progress);
+  void ChangePin(Credentials& credentials, ReportProgressFunction& report_progress);
+  void ChangePassword(Credentials& credentials, ReportProgressFunction& report_progress);
+
+  void ValidateUserInputEdit(const UserInputEdit& edit,
+                              std::map<InputField, uint32_t>& sizes) const;
+  bool HasUserInput(InputField input_field) const;
+  uint32_t UserInputSize(InputField input_field) const;
+  CredentialsPtr CopyCredentials();
+  bool ConfirmCurrentPassword(Credentials& credentials) const;
   void ResetInput();
   void ResetConfirmationInput();
+  template<typename Functor> std::future<void> Post(Functor functor);
+  // Posts 'functor' and waits for it, rethrowing any exception.  Throws if called on the worker
+  // thread, where it would deadlock.
+  template<typename Functor> void Run(Functor functor);
 
-  bool logged_in_;
+  std::atomic<bool> logged_in_;
   std::unique_ptr<Keyword> keyword_, confirmation_keyword_;
   std::unique_ptr<Pin> pin_, confirmation_pin_;
   std::unique_ptr<Password> password_, confirmation_password_, current_password_;
+  // Number of characters in each of the inputs above, see detail::InsertUserInput.
+  std::map<InputField, uint32_t> input_sizes_;
   Session session_;
   ClientMaid client_maid_;
   ClientMpid client_mpid_;
+  AsioService asio_service_;
+  // The single thread of asio_service_, on which all the operations run.
+  std::thread::id worker_thread_id_;
 };
 
 }  // namespace lifestuff
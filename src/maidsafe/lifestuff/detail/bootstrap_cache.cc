@@ -0,0 +1,172 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/bootstrap_cache.h"
+
+#include <algorithm>
+#include <set>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/bootstrap_cache.pb.h"
+#include "maidsafe/lifestuff/detail/file_utils.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+const size_t kMaxEntries(64);
+const int64_t kMaxAge(7 * 24 * 60 * 60 * 1000LL);
+
+int64_t Now() {
+  return GetDurationSinceEpoch().total_milliseconds();
+}
+
+// Serialises the read, merge and write of saves by different caches in this process, so that
+// neither drops the other's entries.
+std::mutex save_mutex;
+
+}  // unnamed namespace
+
+BootstrapCache::BootstrapCache(const boost::filesystem::path& file_path)
+    : kFilePath_(file_path),
+      entries_(),
+      mutex_() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  MergeFile();
+}
+
+void BootstrapCache::Seen(const EndPoint& endpoint) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[endpoint].last_seen = Now();
+  Trim();
+}
+
+void BootstrapCache::RecordRtt(const EndPoint& endpoint, std::chrono::milliseconds rtt) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry(entries_[endpoint]);
+  int64_t sample(std::max(static_cast<int64_t>(rtt.count()), static_cast<int64_t>(1)));
+  entry.rtt = (entry.rtt == 0) ? sample : (7 * entry.rtt + sample) / 8;
+  Trim();
+}
+
+BootstrapCache::EndPointVector BootstrapCache::Ranked() const {
+  std::vector<std::pair<EndPoint, Entry>> ranked;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t oldest(Now() - kMaxAge);
+    for (auto& entry : entries_) {
+      if (entry.second.last_seen >= oldest)
+        ranked.push_back(entry);
+    }
+  }
+  std::sort(ranked.begin(), ranked.end(),
+            [](const std::pair<EndPoint, Entry>& lhs, const std::pair<EndPoint, Entry>& rhs) {
+              if ((lhs.second.rtt == 0) != (rhs.second.rtt == 0))
+                return rhs.second.rtt == 0;
+              if (lhs.second.rtt != rhs.second.rtt)
+                return lhs.second.rtt < rhs.second.rtt;
+              return lhs.second.last_seen > rhs.second.last_seen;
+            });
+  EndPointVector endpoints;
+  for (auto& entry : ranked)
+    endpoints.push_back(entry.first);
+  return endpoints;
+}
+
+BootstrapCache::EndPointVector BootstrapCache::Merge(const EndPointVector& endpoints) const {
+  EndPointVector merged(Ranked());
+  std::set<EndPoint> included(merged.begin(), merged.end());
+  for (auto& endpoint : endpoints) {
+    if (included.insert(endpoint).second)
+      merged.push_back(endpoint);
+  }
+  return merged;
+}
+
+BootstrapCache::EndPointVector BootstrapCache::Interleave(const EndPointVector& endpoints) const {
+  EndPointVector ranked(Ranked());
+  std::set<EndPoint> included(ranked.begin(), ranked.end());
+  EndPointVector fresh;
+  for (auto& endpoint : endpoints) {
+    if (included.insert(endpoint).second)
+      fresh.push_back(endpoint);
+  }
+  EndPointVector interleaved;
+  for (size_t i(0); i != std::max(ranked.size(), fresh.size()); ++i) {
+    if (i < ranked.size())
+      interleaved.push_back(ranked[i]);
+    if (i < fresh.size())
+      interleaved.push_back(fresh[i]);
+  }
+  return interleaved;
+}
+
+void BootstrapCache::Save() {
+  std::lock_guard<std::mutex> save_lock(save_mutex);
+  BootstrapCacheData cache;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MergeFile();
+    for (auto& entry : entries_) {
+      auto cache_entry(cache.add_entries());
+      cache_entry->set_ip(entry.first.first);
+      cache_entry->set_port(entry.first.second);
+      cache_entry->set_last_seen(entry.second.last_seen);
+      cache_entry->set_rtt(entry.second.rtt);
+    }
+  }
+  if (!ReplaceFile(kFilePath_, cache.SerializeAsString()))
+    LOG(kWarning) << "Failed to write bootstrap cache " << kFilePath_;
+}
+
+void BootstrapCache::MergeFile() {
+  std::string content;
+  if (!ReadFile(kFilePath_, &content) || content.empty())
+    return;
+  BootstrapCacheData cache;
+  if (!cache.ParseFromString(content)) {
+    LOG(kWarning) << "Ignoring unparseable bootstrap cache " << kFilePath_;
+    return;
+  }
+  for (auto& cache_entry : cache.entries()) {
+    Entry& entry(entries_[std::make_pair(cache_entry.ip(),
+                                         static_cast<uint16_t>(cache_entry.port()))]);
+    entry.last_seen = std::max(entry.last_seen, static_cast<int64_t>(cache_entry.last_seen()));
+    if (entry.rtt == 0)
+      entry.rtt = cache_entry.rtt();
+  }
+  Trim();
+}
+
+void BootstrapCache::Trim() {
+  // Evicts the least recently seen entries beyond the limit.
+  while (entries_.size() > kMaxEntries) {
+    auto oldest(std::min_element(entries_.begin(), entries_.end(),
+                                 [](const std::pair<const EndPoint, Entry>& lhs,
+                                    const std::pair<const EndPoint, Entry>& rhs) {
+                                   return lhs.second.last_seen < rhs.second.last_seen;
+                                 }));
+    entries_.erase(oldest);
+  }
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
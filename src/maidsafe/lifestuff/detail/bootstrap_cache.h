@@ -0,0 +1,86 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_BOOTSTRAP_CACHE_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_BOOTSTRAP_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// Bootstrap endpoints learned from the network, persisted across runs with the time each was last
+// seen and a smoothed round trip time measured when joining through it.  Shared by all accounts on
+// this machine.
+class BootstrapCache {
+ public:
+  typedef std::pair<std::string, uint16_t> EndPoint;
+  typedef std::vector<EndPoint> EndPointVector;
+
+  // Loads any existing cache from 'file_path'.  An unreadable cache is logged and ignored.
+  explicit BootstrapCache(const boost::filesystem::path& file_path);
+
+  // To be called only for endpoints known to be reachable, e.g. reported by routing.
+  void Seen(const EndPoint& endpoint);
+  // Updates the smoothed RTT of 'endpoint', but not when it was last seen, so an endpoint which is
+  // never confirmed by Seen still ages out.
+  void RecordRtt(const EndPoint& endpoint, std::chrono::milliseconds rtt);
+  // Endpoints with a measured RTT first, fastest first, then the others, most recently seen first.
+  // Endpoints not seen for a week are omitted.
+  EndPointVector Ranked() const;
+  // Returns Ranked() followed by those of 'endpoints' not already included.
+  EndPointVector Merge(const EndPointVector& endpoints) const;
+  // As Merge, but alternates between Ranked() and the rest of 'endpoints', so that any prefix of
+  // the result, e.g. the window raced by RaceBootstrap, includes endpoints from both.
+  EndPointVector Interleave(const EndPointVector& endpoints) const;
+  // Merges the entries now in the file, which other clients may have saved since this one loaded
+  // it, with those held here and atomically replaces the file with the result.  An endpoint in
+  // both keeps the later last seen time and, if measured here, the RTT held here.  Failures are
+  // logged but not thrown; the cache is only an optimisation.
+  void Save();
+
+ private:
+  BootstrapCache(const BootstrapCache&);
+  BootstrapCache& operator=(const BootstrapCache&);
+
+  struct Entry {
+    Entry() : last_seen(0), rtt(0) {}
+    int64_t last_seen, rtt;
+  };
+
+  // Merges the file's entries into entries_ as described for Save.  Call with mutex_ held.
+  void MergeFile();
+  void Trim();
+
+  const boost::filesystem::path kFilePath_;
+  std::map<EndPoint, Entry> entries_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_BOOTSTRAP_CACHE_H_
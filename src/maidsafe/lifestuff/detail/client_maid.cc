@@ -18,55 +18,166 @@
 
 #include "maidsafe/lifestuff/detail/client_maid.h"
 
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <set>
+#include <utility>
+
+#include "maidsafe/lifestuff/detail/trace.h"
+#include "maidsafe/lifestuff/detail/utils.h"
+
 namespace maidsafe {
 namespace lifestuff {
 
-ClientMaid::ClientMaid(Session& session, const Slots& slots)
+namespace {
+
+// A session whose only change is its used space is re-stored at most this often, other than when
+// logging out.
+const std::chrono::minutes kUsedSpaceSaveInterval(5);
+
+// Unless given, the cache files are shared by all accounts on this machine.
+boost::filesystem::path CacheFilePath(const std::string& path, const std::string& default_name) {
+  return path.empty() ? GetHomeDir() / kAppHomeDirectory / default_name
+                      : boost::filesystem::path(path);
+}
+
+PublicKeyCacheOptions PersistentPublicKeyCacheOptions(const ClientOptions& options) {
+  PublicKeyCacheOptions public_key_cache_options;
+  public_key_cache_options.file_path =
+      CacheFilePath(options.public_key_cache_path, "public_key_cache");
+  return public_key_cache_options;
+}
+
+ExecutorOptions MakeExecutorOptions(const ClientOptions& options) {
+  ExecutorOptions executor_options;
+  executor_options.thread_count = options.executor_threads;
+  executor_options.cpu_affinity = options.executor_cpu_affinity;
+  return executor_options;
+}
+
+// A racer joining under its own RoutingHandler; see RaceBootstrap.
+class RoutingRacer : public JoinRacer {
+ public:
+  RoutingRacer(const passport::Maid& maid,
+               Executor& executor,
+               PublicKeyRequestFunction public_key_request)
+      : routing_handler_(maid, executor, public_key_request) {}
+
+  virtual void Join(const RoutingHandler::EndPointVector& endpoints,
+                    const RoutingHandler::JoinObservers& join_observers) {
+    routing_handler_.Join(endpoints, join_observers);
+  }
+
+ private:
+  RoutingRacer(const RoutingRacer&);
+  RoutingRacer& operator=(const RoutingRacer&);
+
+  RoutingHandler routing_handler_;
+};
+
+}  // unnamed namespace
+
+ClientMaid::ClientMaid(Session& session,
+                       const Slots& slots,
+                       const ClientOptions& options)
   : slots_(CheckSlots(slots)),
     session_(session),
-    client_controller_(new ClientController(slots_.update_available)),
+    fob_pool_(options.fob_pool_depth, kDefaultFobPoolThreads),
+    phase_recorder_(),
+    session_cache_(),
+    session_revalidation_(),
+    last_session_save_(),
+    rotation_journal_(),
+    rotation_journal_mutex_(),
+    pending_deletions_(),
+    client_controller_(),
+    client_controller_mutex_(),
     storage_(),
+    network_(),
+    hedged_getter_(),
     user_storage_(),
-    routing_handler_() {
+    executor_(MakeExecutorOptions(options)),
+    bootstrap_endpoints_(),
+    bootstrap_cache_(CacheFilePath(options.bootstrap_cache_path, "bootstrap_cache")),
+    public_key_cache_([this](const NodeId& node_id) { return FetchPublicKey(node_id); },
+                      PersistentPublicKeyCacheOptions(options)),
+    kRacingJoin_(options.racing_join),
+    racer_maids_(),
+    last_join_report_(),
+    join_report_mutex_(),
+    routing_handler_() {}
+
+ClientMaid::~ClientMaid() {
+  if (session_revalidation_.valid())
+    session_revalidation_.wait();
+  WaitForPendingDeletions();
+  routing_handler_.reset();
+  bootstrap_cache_.Save();
+  public_key_cache_.Save();
 }
 
-ClientMaid::~ClientMaid() {}
+void ClientMaid::PrepareCreateUser() {
+  fob_pool_.Start();
+}
 
 void ClientMaid::CreateUser(const Keyword& keyword,
                             const Pin& pin,
                             const Password& password,
                             const boost::filesystem::path& storage_path,
                             ReportProgressFunction& report_progress) {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::CreateUser");
+  PhaseRecorder::Scope progress(phase_recorder_, report_progress);
+  // Vault start-up only needs the fobs, so it overlaps joining and the free fob puts.  Likewise
+  // the drive mount check overlaps the paid fob puts.  Progress is still reported in order from
+  // this thread.
   bool fobs_confirmed(false), drive_mounted(false);
+  std::future<void> vault_started, drive_checked;
   try {
-    report_progress(kCreateUser, kCreatingUserCredentials);
-    session_.passport().CreateFobs();
+    progress(kCreateUser, kCreatingUserCredentials);
+    session_.set_passport(fob_pool_.Take());
     Maid maid(session_.passport().template Get<Maid>(false));
-    report_progress(kCreateUser, kJoiningNetwork);
-    JoinNetwork(maid);
-    PutFreeFobs();
-    report_progress(kCreateUser, kInitialisingClientComponents);
-//    storage_.reset(new Storage(routing_handler_->routing(), maid));
-    report_progress(kCreateUser, kCreatingVault);
     Pmid pmid(session_.passport().template Get<Pmid>(false));
     session_.set_storage_path(storage_path);
-    client_controller_->StartVault(pmid, maid.name(), storage_path);
+    // The fobs are copied in as they go out of scope before the catch block waits for this task.
+    vault_started = std::async(std::launch::async, [this, pmid, maid, storage_path] {
+                                 StartVault(pmid, maid.name(), storage_path);
+                               });
+    progress(kCreateUser, kJoiningNetwork);
+    JoinNetwork(maid, true);
+    RethrowFirstFailure(PutPublicFobs<Free>());
+    progress(kCreateUser, kInitialisingClientComponents);
+//    storage_.reset(new Storage(routing_handler_->routing(), maid));
+    progress(kCreateUser, kCreatingVault);
+    vault_started.get();
     RegisterPmid(maid, pmid);
-    report_progress(kCreateUser, kCreatingUserCredentials);
+    progress(kCreateUser, kCreatingUserCredentials);
     session_.passport().ConfirmFobs();
+    session_.set_passport_modified();
     fobs_confirmed = true;
-    PutPaidFobs();
     session_.set_unique_user_id(Identity(RandomAlphaNumericString(64)));
-    MountDrive();
-    drive_mounted = true;
-    UnMountDrive();
-    drive_mounted = false;
+    // The drive is not served by a Network, so there is nothing to check against one.
+    if (!network_) {
+      drive_checked = std::async(std::launch::async, [this, &drive_mounted] {
+                                   MountDrive();
+                                   drive_mounted = true;
+                                   UnMountDrive();
+                                   drive_mounted = false;
+                                 });
+    }
+    RethrowFirstFailure(PutPublicFobs<Paid>());
+    if (drive_checked.valid())
+      drive_checked.get();
     session_.set_initialised();
-    report_progress(kCreateUser, kStoringUserCredentials);
-    PutSession(keyword, pin, password);
+    progress(kCreateUser, kStoringUserCredentials);
+    PutSession(keyword, pin, password, false);
     session_.set_keyword_pin_password(keyword, pin, password);
   }
   catch(const std::exception& e) {
+    // Branches still in flight use the controller, the drive and 'drive_mounted', so they must
+    // finish before UnCreateUser undoes their work.
+    detail::WaitQuietly(vault_started);
+    detail::WaitQuietly(drive_checked);
     UnCreateUser(fobs_confirmed, drive_mounted);
     boost::throw_exception(e);
   }
@@ -78,24 +189,37 @@ void ClientMaid::LogIn(const Keyword& keyword,
                        const Password& password,
                        const boost::filesystem::path& /*storage_path*/,
                        ReportProgressFunction& report_progress) {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::LogIn");
+  PhaseRecorder::Scope progress(phase_recorder_, report_progress);
   try {
-    Anmaid anmaid;
-    Maid maid(anmaid);
-    report_progress(kLogin, kJoiningNetwork);
-    JoinNetwork(maid);
-    report_progress(kLogin, kInitialisingClientComponents);
-//    storage_.reset(new Storage(routing_handler_->routing(), maid));
-    report_progress(kLogin, kRetrievingUserCredentials);
-    GetSession(keyword, pin, password);
-    maid = session_.passport().template Get<Maid>(true);
+    bool warm_start(false);
+    if (session_cache_) {
+      progress(kLogin, kRetrievingUserCredentials);
+      warm_start = GetCachedSession(keyword, pin, password);
+    }
+    if (!warm_start) {
+      Anmaid anmaid;
+      Maid anonymous_maid(anmaid);
+      progress(kLogin, kJoiningNetwork);
+      JoinNetwork(anonymous_maid, true);
+      progress(kLogin, kInitialisingClientComponents);
+//    storage_.reset(new Storage(routing_handler_->routing(), anonymous_maid));
+      progress(kLogin, kRetrievingUserCredentials);
+      GetSession(keyword, pin, password);
+    }
+    Maid maid(session_.passport().template Get<Maid>(true));
     Pmid pmid(session_.passport().template Get<Pmid>(true));
-    report_progress(kLogin, kJoiningNetwork);
-    JoinNetwork(maid);
-    report_progress(kLogin, kInitialisingClientComponents);
+    progress(kLogin, kJoiningNetwork);
+    // Only the first join of a login races; this one starts from that race's winner.
+    JoinNetwork(maid, warm_start);
+    progress(kLogin, kInitialisingClientComponents);
 //    storage_.reset(new Storage(routing_handler_->routing(), maid));
-    report_progress(kLogin, kStartingVault);
-    client_controller_->StartVault(pmid, maid.name(), session_.storage_path());
+    progress(kLogin, kStartingVault);
+    StartVault(pmid, maid.name(), session_.storage_path());
     session_.set_keyword_pin_password(keyword, pin, password);
+    ResumeCredentialRotation();
+    if (warm_start)
+      RevalidateSession();
   }
   catch(const std::exception& e) {
     // client_controller_->StopVault(); get params!!!!!!!!!
@@ -106,16 +230,31 @@ void ClientMaid::LogIn(const Keyword& keyword,
 }
 
 void ClientMaid::LogOut() {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::LogOut");
+  ReconcileSession();
+  WaitForPendingDeletions();
+  {
+    // The journal belongs to this account; the next one to log in opens its own.
+    std::lock_guard<std::mutex> lock(rotation_journal_mutex_);
+    rotation_journal_.reset();
+  }
   //  client_controller_->StopVault(  );  parameters???
   UnMountDrive();
+  SaveSession(true);
 }
 
 void ClientMaid::MountDrive() {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::MountDrive");
+  ReconcileSession();
+  if (!storage_)
+    ThrowError(CommonErrors::uninitialised);
   user_storage_.MountDrive(*storage_, session_);
+  SaveSession(false);
   return;
 }
 
 void ClientMaid::UnMountDrive() {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::UnMountDrive");
   user_storage_.UnMountDrive(session_);
   return;
 }
@@ -125,9 +264,11 @@ void ClientMaid::ChangeKeyword(const Keyword& old_keyword,
                                const Pin& pin,
                                const Password& password,
                                ReportProgressFunction& report_progress) {
-  report_progress(kChangeKeyword, kStoringUserCredentials);
-  PutSession(new_keyword, pin, password);
-  DeleteSession(old_keyword, pin);
+  LIFESTUFF_TRACE_SPAN("ClientMaid::ChangeKeyword");
+  PhaseRecorder::Scope progress(phase_recorder_, report_progress);
+  ReconcileSession();
+  progress(kChangeKeyword, kStoringUserCredentials);
+  RotateSession(old_keyword, pin, new_keyword, pin, password);
   session_.set_keyword(new_keyword);
   return;
 }
@@ -137,9 +278,11 @@ void ClientMaid::ChangePin(const Keyword& keyword,
                            const Pin& new_pin,
                            const Password& password,
                            ReportProgressFunction& report_progress) {
-  report_progress(kChangePin, kStoringUserCredentials);
-  PutSession(keyword, new_pin, password);
-  DeleteSession(keyword, old_pin);
+  LIFESTUFF_TRACE_SPAN("ClientMaid::ChangePin");
+  PhaseRecorder::Scope progress(phase_recorder_, report_progress);
+  ReconcileSession();
+  progress(kChangePin, kStoringUserCredentials);
+  RotateSession(keyword, old_pin, keyword, new_pin, password);
   session_.set_pin(new_pin);
   return;
 }
@@ -148,8 +291,11 @@ void ClientMaid::ChangePassword(const Keyword& keyword,
                                 const Pin& pin,
                                 const Password& new_password,
                                 ReportProgressFunction& report_progress) {
-  report_progress(kChangePassword, kStoringUserCredentials);
-  PutSession(keyword, pin, new_password);
+  LIFESTUFF_TRACE_SPAN("ClientMaid::ChangePassword");
+  PhaseRecorder::Scope progress(phase_recorder_, report_progress);
+  ReconcileSession();
+  progress(kChangePassword, kStoringUserCredentials);
+  PutSession(keyword, pin, new_password, true);
   session_.set_password(new_password);
   return;
 }
@@ -162,6 +308,55 @@ boost::filesystem::path ClientMaid::owner_path() {
   return user_storage_.owner_path();
 }
 
+FobPool::Metrics ClientMaid::fob_pool_metrics() const {
+  return fob_pool_.metrics();
+}
+
+PublicKeyCache::Metrics ClientMaid::public_key_cache_metrics() const {
+  return public_key_cache_.metrics();
+}
+
+HedgedGetter::Metrics ClientMaid::hedged_getter_metrics() const {
+  return hedged_getter_ ? hedged_getter_->metrics() : HedgedGetter::Metrics();
+}
+
+void ClientMaid::UseNetwork(std::shared_ptr<Network> network) {
+  network_ = network;
+  // The getter may abandon a stalled request and outlive this client, so it holds 'network' rather
+  // than this.
+  hedged_getter_.reset(new HedgedGetter([network](const Identity& name, uint32_t holder) {
+                                          return network->Get(name, holder);
+                                        },
+                                        HedgedGetOptions()));
+}
+
+JoinReport ClientMaid::last_join_report() const {
+  std::lock_guard<std::mutex> lock(join_report_mutex_);
+  return last_join_report_;
+}
+
+Executor& ClientMaid::executor() {
+  return executor_;
+}
+
+const Executor& ClientMaid::executor() const {
+  return executor_;
+}
+
+const PhaseRecorder& ClientMaid::phase_recorder() const {
+  return phase_recorder_;
+}
+
+void ClientMaid::EnableSessionCache(bool enable) {
+  // Background revalidation and deletions use the cache, so they are drained before it changes.
+  ReconcileSession();
+  WaitForPendingDeletions();
+  if (enable && !session_cache_)
+    session_cache_.reset(new SessionCache(GetHomeDir() / kAppHomeDirectory / "session_cache"));
+  else if (!enable)
+    session_cache_.reset();
+}
+
 const Slots& ClientMaid::CheckSlots(const Slots& slots) {
   if (!slots.update_available)
     ThrowError(CommonErrors::uninitialised);
@@ -172,7 +367,11 @@ const Slots& ClientMaid::CheckSlots(const Slots& slots) {
   return slots;
 }
 
-void ClientMaid::PutSession(const Keyword& keyword, const Pin& pin, const Password& password) {
+void ClientMaid::PutSession(const Keyword& keyword,
+                            const Pin& pin,
+                            const Password& password,
+                            bool overwrite_mid) {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::PutSession");
   NonEmptyString serialised_session(session_.Serialise());
   passport::EncryptedSession encrypted_session(passport::EncryptSession(
                                                   keyword, pin, password, serialised_session));
@@ -181,49 +380,400 @@ void ClientMaid::PutSession(const Keyword& keyword, const Pin& pin, const Passwo
                                                     keyword, pin, tmid.name()));
   Mid::Name mid_name(passport::MidName(keyword, pin));
   Mid mid(mid_name, encrypted_tmid_name, session_.passport().template Get<Anmid>(true));
-  PutFob<Tmid>(tmid);
-  PutFob<Mid>(mid);
-}
-
-void ClientMaid::DeleteSession(const Keyword& /*keyword*/, const Pin& /*pin*/) {
-  /*Mid::Name mid_name(Mid::GenerateName(keyword, pin));
-  auto data(storage_->Get(mid_name));
-  Mid mid(*mid_future.get());
-  passport::EncryptedTmidName encrypted_tmid_name(mid.encrypted_tmid_name());
-  Tmid::Name tmid_name(passport::DecryptTmidName(keyword, pin, encrypted_tmid_name));
-  DeleteFob<Tmid>(tmid_name);
-  DeleteFob<Mid>(mid_name);*/
-}
-
-void ClientMaid::GetSession(const Keyword& /*keyword*/, const Pin& /*pin*/, const Password& /*password*/) {
-  /*Mid::Name mid_name(Mid::GenerateName(keyword, pin));
-  auto mid_future(maidsafe::nfs::Get<Mid>(*storage_, mid_name));
-  Mid mid(*mid_future.get());
-  passport::EncryptedTmidName encrypted_tmid_name(mid.encrypted_tmid_name());
-  Tmid::Name tmid_name(passport::DecryptTmidName(keyword, pin, encrypted_tmid_name));
-  auto tmid_future(maidsafe::nfs::Get<Tmid>(*storage_, tmid_name));
-  Tmid tmid(*tmid_future.get());
-  passport::EncryptedSession encrypted_session(tmid.encrypted_session());
+  Pmid::Name pmid_name(session_.passport().template Get<Pmid>(true).name());
+  if (overwrite_mid) {
+    // The existing MID must not point at the new TMID before the TMID is stored.
+    PutFob<Tmid>(tmid, pmid_name);
+    PutFob<Mid>(mid, pmid_name);
+  } else {
+    // Nothing refers to a brand new MID yet, so both can be stored at once.  If either fails, the
+    // other is removed again on a best-effort basis.
+    std::future<void> tmid_put(std::async(std::launch::async, [this, &tmid, &pmid_name] {
+                                            PutFob<Tmid>(tmid, pmid_name);
+                                          }));
+    try {
+      PutFob<Mid>(mid, pmid_name);
+    }
+    catch(const std::exception&) {
+      detail::WaitQuietly(tmid_put);
+      try { DeleteFob<Tmid>(tmid.name()); } catch(...) { /* consume exception */ }
+      throw;
+    }
+    try {
+      tmid_put.get();
+    }
+    catch(const std::exception&) {
+      try { DeleteFob<Mid>(mid_name); } catch(...) { /* consume exception */ }
+      throw;
+    }
+  }
+  session_.MarkSaved();
+  last_session_save_ = std::chrono::steady_clock::now();
+  if (session_cache_) {
+    session_cache_->Put(mid_name, encrypted_session);
+    session_cache_->PutTmidName(mid_name, encrypted_tmid_name);
+  }
+}
+
+void ClientMaid::SaveSession(bool flush) {
+  if (!session_.initialised())
+    return;
+  // Bootstrap endpoints are kept in the local bootstrap cache rather than the stored session.
+  uint32_t modified_fields(session_.modified_fields() & ~Session::kBootstrapEndpointsModified);
+  if (modified_fields == 0)
+    return;
+  if (!flush && modified_fields == Session::kUsedSpaceModified &&
+      std::chrono::steady_clock::now() - last_session_save_ < kUsedSpaceSaveInterval) {
+    LOG(kVerbose) << "Deferring save of session with only used space changed.";
+    return;
+  }
+  PutSession(session_.keyword(), session_.pin(), session_.password(), true);
+}
+
+void ClientMaid::DeleteSession(const Mid::Name& mid_name, const Tmid::Name& tmid_name) {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::DeleteSession");
+  if (session_cache_)
+    session_cache_->Delete(mid_name);
+  if (tmid_name.data.IsInitialised())
+    DeleteFob<Tmid>(tmid_name);
+  else
+    LOG(kWarning) << "Name of replaced TMID unknown, deleting its MID only.";
+  DeleteFob<Mid>(mid_name);
+}
+
+void ClientMaid::RotateSession(const Keyword& old_keyword,
+                               const Pin& old_pin,
+                               const Keyword& new_keyword,
+                               const Pin& new_pin,
+                               const Password& password) {
+  // The old MID is journalled before the new credentials are stored, and its TMID's name is looked
+  // up meanwhile.  Once the new pair is durable the rotation has succeeded: the old pair is deleted
+  // in the background, and failing to find the old TMID only means it is left behind.
+  Mid::Name old_mid_name(passport::MidName(old_keyword, old_pin));
+  rotation_journal().Add(old_mid_name);
+  std::future<Tmid::Name> old_tmid_name(std::async(std::launch::async, [&] {
+      Mid old_mid(GetFob<Mid>(old_mid_name));
+      return passport::DecryptTmidName(old_keyword, old_pin, old_mid.encrypted_tmid_name());
+    }));
+  try {
+    PutSession(new_keyword, new_pin, password, false);
+  }
+  catch(const std::exception&) {
+    detail::WaitQuietly(old_tmid_name);
+    try { rotation_journal().Remove(old_mid_name); } catch(...) { /* consume exception */ }
+    throw;
+  }
+  Tmid::Name tmid_name;
+  try {
+    tmid_name = old_tmid_name.get();
+    rotation_journal().Add(old_mid_name, tmid_name);
+  }
+  catch(const std::exception& e) {
+    LOG(kWarning) << "Failed to look up the replaced session's TMID: " << e.what();
+  }
+  DeleteSessionAsync(old_mid_name, tmid_name);
+}
+
+void ClientMaid::DeleteSessionAsync(const Mid::Name& mid_name, const Tmid::Name& tmid_name) {
+  bool deletions_pending(!pending_deletions_.empty());
+  // Failed deletions stay in the journal and are retried at the next login.
+  pending_deletions_.erase(
+      std::remove_if(pending_deletions_.begin(), pending_deletions_.end(),
+                     [](std::future<void>& pending_deletion)->bool {
+                       if (pending_deletion.wait_for(std::chrono::seconds(0)) !=
+                           std::future_status::ready)
+                         return false;
+                       detail::WaitQuietly(pending_deletion);
+                       return true;
+                     }),
+      pending_deletions_.end());
+  if (!deletions_pending)
+    slots_.operations_pending(true);
+  pending_deletions_.push_back(std::async(std::launch::async, [this, mid_name, tmid_name] {
+      DeleteSession(mid_name, tmid_name);
+      rotation_journal().Remove(mid_name);
+    }));
+}
+
+void ClientMaid::ResumeCredentialRotation() {
+  Mid::Name current_mid_name(passport::MidName(session_.keyword(), session_.pin()));
+  for (auto& entry : rotation_journal().ResumableEntries(current_mid_name)) {
+    LOG(kInfo) << "Resuming deletion of session replaced by an interrupted credential change.";
+    DeleteSessionAsync(entry.first, entry.second);
+  }
+}
+
+void ClientMaid::WaitForPendingDeletions() {
+  if (pending_deletions_.empty())
+    return;
+  // Failed deletions stay in the journal and are retried at the next login.
+  for (auto& pending_deletion : pending_deletions_)
+    detail::WaitQuietly(pending_deletion);
+  pending_deletions_.clear();
+  slots_.operations_pending(false);
+}
+
+RotationJournal& ClientMaid::rotation_journal() {
+  std::lock_guard<std::mutex> lock(rotation_journal_mutex_);
+  if (!rotation_journal_) {
+    rotation_journal_.reset(new RotationJournal(
+        GetHomeDir() / kAppHomeDirectory / "rotation_journal" /
+        EncodeToHex(crypto::Hash<crypto::SHA1>(session_.unique_user_id()))));
+  }
+  return *rotation_journal_;
+}
+
+void ClientMaid::GetSession(const Keyword& keyword, const Pin& pin, const Password& password) {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::GetSession");
+  passport::EncryptedSession encrypted_session(GetEncryptedSession(keyword, pin));
   NonEmptyString serialised_session(passport::DecryptSession(
                                       keyword, pin, password, encrypted_session));
   session_.Parse(serialised_session);
-  session_.set_initialised();*/
+  session_.set_initialised();
+  if (session_cache_)
+    session_cache_->Put(passport::MidName(keyword, pin), encrypted_session);
 }
 
-void ClientMaid::JoinNetwork(const Maid& maid) {
+passport::EncryptedSession ClientMaid::GetEncryptedSession(const Keyword& keyword,
+                                                           const Pin& pin) {
+  // If the TMID name from the last MID seen is remembered locally, fetch that TMID alongside the
+  // MID rather than after it.  The MID still decides which TMID is used.
+  Mid::Name mid_name(passport::MidName(keyword, pin));
+  std::future<Mid> mid_future(std::async(std::launch::async, [this, &mid_name] {
+                                           return GetFob<Mid>(mid_name);
+                                         }));
+  std::unique_ptr<Tmid::Name> predicted_tmid_name;
+  std::future<Tmid> predicted_tmid_future;
+  passport::EncryptedTmidName cached_tmid_name;
+  if (session_cache_ && session_cache_->GetTmidName(mid_name, cached_tmid_name)) {
+    try {
+      predicted_tmid_name.reset(new Tmid::Name(
+          passport::DecryptTmidName(keyword, pin, cached_tmid_name)));
+      // The prefetch runs on the executor and owns its result, so a mispredicted one is simply
+      // abandoned rather than waited for.
+      std::shared_ptr<std::promise<Tmid>> prefetch(std::make_shared<std::promise<Tmid>>());
+      predicted_tmid_future = prefetch->get_future();
+      Tmid::Name tmid_name(*predicted_tmid_name);
+      executor_.Post([this, prefetch, tmid_name] {
+                       try {
+                         prefetch->set_value(GetFob<Tmid>(tmid_name));
+                       }
+                       catch(...) {
+                         prefetch->set_exception(std::current_exception());
+                       }
+                     });
+    }
+    catch(const std::exception& e) {
+      LOG(kWarning) << "Ignoring unusable cached TMID name: " << e.what();
+      predicted_tmid_name.reset();
+    }
+  }
+
+  Mid mid(mid_future.get());
+  Tmid::Name tmid_name(passport::DecryptTmidName(keyword, pin, mid.encrypted_tmid_name()));
+  if (predicted_tmid_name && *predicted_tmid_name == tmid_name) {
+    try {
+      return predicted_tmid_future.get().encrypted_session();
+    }
+    catch(const std::exception& e) {
+      LOG(kWarning) << "Prefetched TMID unavailable, retrying: " << e.what();
+    }
+  } else if (session_cache_) {
+    session_cache_->PutTmidName(mid_name, mid.encrypted_tmid_name());
+  }
+  // A mispredicted prefetch may still be running; its result is discarded when it completes.
+  return GetFob<Tmid>(tmid_name).encrypted_session();
+}
+
+bool ClientMaid::GetCachedSession(const Keyword& keyword,
+                                  const Pin& pin,
+                                  const Password& password) {
+  passport::EncryptedSession encrypted_session;
+  Mid::Name mid_name(passport::MidName(keyword, pin));
+  if (!session_cache_->Get(mid_name, encrypted_session))
+    return false;
+  // Failing to decrypt the entry most likely means a mistyped password, which is no reason to
+  // discard it; the network copy is used instead.
+  std::unique_ptr<NonEmptyString> serialised_session;
+  try {
+    serialised_session.reset(new NonEmptyString(
+        passport::DecryptSession(keyword, pin, password, encrypted_session)));
+  }
+  catch(const std::exception& e) {
+    LOG(kWarning) << "Failed to decrypt cached session: " << e.what();
+    return false;
+  }
+  try {
+    session_.Parse(*serialised_session);
+    // Parse defers decoding the keyring, so it is forced here for a corrupt one to be caught.
+    session_.passport().template Get<Maid>(true);
+    session_.passport().template Get<Pmid>(true);
+    session_.set_initialised();
+    return true;
+  }
+  catch(const std::exception& e) {
+    LOG(kWarning) << "Discarding unusable cached session: " << e.what();
+    session_cache_->Delete(mid_name);
+    return false;
+  }
+}
+
+void ClientMaid::RevalidateSession() {
+  session_revalidation_ = std::async(std::launch::async, [this]()->SerialisedSessionPtr {
+      LIFESTUFF_TRACE_SPAN("ClientMaid::RevalidateSession");
+      passport::EncryptedSession encrypted_session(
+          GetEncryptedSession(session_.keyword(), session_.pin()));
+      NonEmptyString serialised_session(passport::DecryptSession(
+          session_.keyword(), session_.pin(), session_.password(), encrypted_session));
+      if (Session::ParseTimestamp(serialised_session) <= session_.timestamp())
+        return SerialisedSessionPtr();
+      LOG(kInfo) << "Network copy of session is newer than the cached copy.";
+      if (session_cache_)
+        session_cache_->Put(passport::MidName(session_.keyword(), session_.pin()),
+                            encrypted_session);
+      return SerialisedSessionPtr(new NonEmptyString(serialised_session));
+    });
+}
+
+void ClientMaid::ReconcileSession() {
+  if (!session_revalidation_.valid())
+    return;
+  SerialisedSessionPtr newer_session;
+  try {
+    newer_session = session_revalidation_.get();
+  }
+  catch(const std::exception& e) {
+    LOG(kWarning) << "Failed to revalidate cached session: " << e.what();
+    return;
+  }
+  if (!newer_session)
+    return;
+  session_.Parse(*newer_session);
+  if (slots_.session_changed)
+    slots_.session_changed();
+}
+
+void ClientMaid::JoinNetwork(const Maid& maid, bool race) {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::JoinNetwork");
+  if (network_) {
+    network_->Join(NodeId(maid.name().data.string()));
+    return;
+  }
   PublicKeyRequestFunction public_key_request(
       [this](const NodeId& node_id, const GivePublicKeyFunctor& give_key) {
         PublicKeyRequest(node_id, give_key);
       });
-  routing_handler_.reset(new RoutingHandler(maid, public_key_request));
+  // Any previous handler (e.g. the anonymous one used to fetch the session during login) is
+  // released before bootstrapping again; the executor and endpoints are reused.
+  routing_handler_.reset();
+
+  if (bootstrap_endpoints_.empty()) {
+    std::vector<boost::asio::ip::udp::endpoint> bootstrap_endpoints;
+    client_controller().GetBootstrapNodes(bootstrap_endpoints);
+    for (auto& endpoint : bootstrap_endpoints)
+      bootstrap_endpoints_.push_back(std::make_pair(endpoint.address().to_string(),
+                                                    endpoint.port()));
+  }
+
+  // Previously learned endpoints are tried first, fastest first, then the controller's.
+  EndPointVector endpoints(bootstrap_cache_.Merge(bootstrap_endpoints_));
+  session_.set_bootstrap_endpoints(endpoints);
+  RoutingHandler::JoinObservers join_observers;
+  join_observers.new_bootstrap_endpoint = [this](const RoutingHandler::EndPoint& endpoint) {
+      bootstrap_cache_.Seen(endpoint);
+    };
+
+  if (kRacingJoin_ && race && endpoints.size() > 1) {
+    // Racers join under throwaway identities, generated once and reused by later races, so that
+    // none shares a NodeId with another or with 'maid'.  The real join below then starts from the
+    // winning endpoint.
+    RacerFactory make_racer([&](size_t racer) {
+        while (racer_maids_.size() <= racer) {
+          Anmaid anmaid;
+          racer_maids_.emplace_back(new Maid(anmaid));
+        }
+        return JoinRacerPtr(new RoutingRacer(*racer_maids_[racer], executor_,
+                                             public_key_request));
+      });
+    // The cache's endpoints alternate with the controller's so that fresh endpoints are raced even
+    // when the cache holds more than kJoinRaceWidth.
+    EndPointVector race_endpoints(bootstrap_cache_.Interleave(bootstrap_endpoints_));
+    JoinReport join_report;
+    bool bootstrapped(RaceBootstrap(make_racer, race_endpoints, join_observers, join_report));
+    // Each racer was given a single endpoint, so one which joined confirms it.
+    for (auto& attempt : join_report.attempts) {
+      if (attempt.joined) {
+        bootstrap_cache_.Seen(attempt.endpoint);
+        bootstrap_cache_.RecordRtt(attempt.endpoint, attempt.join_time);
+      }
+    }
+    bootstrap_cache_.Save();
+    {
+      std::lock_guard<std::mutex> lock(join_report_mutex_);
+      last_join_report_ = join_report;
+    }
+    if (!bootstrapped)
+      LOG(kWarning) << "Falling back to joining via all bootstrap endpoints in order.";
+  }
+  if (kRacingJoin_) {
+    // The winner of this operation's race, if any, is tried first.
+    JoinReport join_report(last_join_report());
+    if (join_report.winner >= 0) {
+      auto winner(std::find(endpoints.begin(), endpoints.end(),
+                            join_report.attempts[join_report.winner].endpoint));
+      if (winner != endpoints.end())
+        std::rotate(endpoints.begin(), winner, winner + 1);
+    }
+  }
 
-  std::vector<boost::asio::ip::udp::endpoint> bootstrap_endpoints;
-  client_controller_->GetBootstrapNodes(bootstrap_endpoints);
-  EndPointVector endpoints;
-  for (auto& endpoint : bootstrap_endpoints)
-    endpoints.push_back(std::make_pair(endpoint.address().to_string(), endpoint.port()));
+  // Routing does not say which of the endpoints it bootstrapped through, so the join time is only
+  // attributed to one of them which routing has since reported back as a bootstrap endpoint, which
+  // confirms it was reached.  If none has been reported by the time of joining, nothing is
+  // recorded.
+  struct JoinAttribution {
+    std::set<RoutingHandler::EndPoint> candidates;
+    std::unique_ptr<RoutingHandler::EndPoint> confirmed;
+    std::mutex mutex;
+  };
+  std::shared_ptr<JoinAttribution> attribution(std::make_shared<JoinAttribution>());
+  attribution->candidates.insert(endpoints.begin(), endpoints.end());
+  join_observers.new_bootstrap_endpoint =
+      [this, attribution](const RoutingHandler::EndPoint& endpoint) {
+        bootstrap_cache_.Seen(endpoint);
+        std::lock_guard<std::mutex> lock(attribution->mutex);
+        if (!attribution->confirmed && attribution->candidates.count(endpoint) != 0)
+          attribution->confirmed.reset(new RoutingHandler::EndPoint(endpoint));
+      };
+  join_observers.joined = [this, attribution](std::chrono::milliseconds join_duration) {
+      {
+        std::lock_guard<std::mutex> lock(attribution->mutex);
+        if (!attribution->confirmed) {
+          LOG(kVerbose) << "Joined without a confirmed bootstrap endpoint; RTT not recorded.";
+          return;
+        }
+        bootstrap_cache_.RecordRtt(*attribution->confirmed, join_duration);
+      }
+      bootstrap_cache_.Save();
+    };
+  routing_handler_.reset(new RoutingHandler(maid, executor_, public_key_request));
+  routing_handler_->Join(endpoints, join_observers);
+}
 
-  routing_handler_->Join(endpoints);
+ClientMaid::ClientController& ClientMaid::client_controller() {
+  std::lock_guard<std::mutex> lock(client_controller_mutex_);
+  if (!client_controller_)
+    client_controller_.reset(new ClientController(slots_.update_available));
+  return *client_controller_;
+}
+
+void ClientMaid::StartVault(const Pmid& pmid,
+                            const Maid::Name& account_name,
+                            const boost::filesystem::path& chunkstore) {
+  if (network_) {
+    network_->StartVault(pmid, account_name, chunkstore);
+    return;
+  }
+  client_controller().StartVault(pmid, account_name, chunkstore);
 }
 
 void ClientMaid::RegisterPmid(const Maid& maid, const Pmid& pmid) {
@@ -259,18 +809,25 @@ void ClientMaid::UnCreateUser(bool fobs_confirmed, bool drive_mounted) {
 }
 
 template<typename Fob>
-void ClientMaid::PutFob(const Fob& /*fob*/) {
+void ClientMaid::PutFob(const Fob& fob, const Pmid::Name& /*pmid_name*/) {
+  if (network_) {
+    network_->Put(fob.name().data, fob.Serialise().data);
+    return;
+  }
   /*ReplyFunction reply([this] (maidsafe::nfs::Reply reply) {
                         if (!reply.IsSuccess()) {
                           ThrowError(LifeStuffErrors::kStoreFailure);
                         }
                       });
-  passport::Pmid::Name pmid_name(session_.passport().template Get<Pmid>(true).name());
   maidsafe::nfs::Put<Fob>(*storage_, fob, pmid_name, 3, reply);*/
 }
 
 template<typename Fob>
-void ClientMaid::DeleteFob(const typename Fob::Name& /*fob_name*/) {
+void ClientMaid::DeleteFob(const typename Fob::Name& fob_name) {
+  if (network_) {
+    network_->Delete(fob_name.data);
+    return;
+  }
   /*ReplyFunction reply([this] (maidsafe::nfs::Reply reply) {
                         if (!reply.IsSuccess()) {
                           ThrowError(LifeStuffErrors::kDeleteFailure);
@@ -280,39 +837,119 @@ void ClientMaid::DeleteFob(const typename Fob::Name& /*fob_name*/) {
 }
 
 template<typename Fob>
-Fob ClientMaid::GetFob(const typename Fob::Name& /*fob_name*/) {
+Fob ClientMaid::GetFob(const typename Fob::Name& fob_name) {
+  if (network_)
+    return Fob(fob_name, typename Fob::serialised_type(hedged_getter_->Get(fob_name.data)));
   /*std::future<Fob> fob_future(maidsafe::nfs::Get<Fob>(*storage_, fob_name));
   return fob_future.get();*/
   return Fob();
 }
 
-void PutFreeFobs() {
-  /*ReplyFunction reply([this] (maidsafe::nfs::Reply reply) {
-                        if (!reply.IsSuccess()) {
-                          ThrowError(VaultErrors::failed_to_handle_request);
-                        }
-                      });
-  detail::PutFobs<Free>()(*storage_, session_.passport(), reply);*/
+// Posts a put of each fob's public part to the executor as it is visited, then waits for all of
+// them.  The puts are charged to the PMID of the passport they are taken from, i.e. the
+// unconfirmed one for the free fobs, which are stored before the PMID is confirmed.
+class ClientMaid::PublicFobPublisher {
+ public:
+  PublicFobPublisher(ClientMaid& client_maid, bool confirmed)
+      : client_maid_(client_maid),
+        kConfirmed_(confirmed),
+        kPmidName_(client_maid.session_.passport().template Get<Pmid>(confirmed).name()),
+        puts_() {}
+
+  ~PublicFobPublisher() {
+    for (auto& put : puts_)
+      detail::WaitQuietly(put.second);
+  }
+
+  template<typename Fob>
+  void Visit() {
+    typedef typename detail::PublicFob<Fob>::type PublicFob;
+    std::shared_ptr<PublicFob> public_fob(std::make_shared<PublicFob>(
+        client_maid_.session_.passport().template Get<Fob>(kConfirmed_)));
+    std::shared_ptr<std::promise<void>> put(std::make_shared<std::promise<void>>());
+    puts_.push_back(std::make_pair(detail::PublicFob<Fob>::name(), put->get_future()));
+    ClientMaid& client_maid(client_maid_);
+    Pmid::Name pmid_name(kPmidName_);
+    client_maid_.executor_.Post([&client_maid, public_fob, pmid_name, put] {
+                                  try {
+                                    client_maid.PutFob(*public_fob, pmid_name);
+                                    put->set_value();
+                                  }
+                                  catch(...) {
+                                    put->set_exception(std::current_exception());
+                                  }
+                                });
+  }
+
+  // Returns the outcome of every put once all have finished; failures are also logged.
+  FobPutStatuses Wait() {
+    FobPutStatuses statuses;
+    for (auto& put : puts_) {
+      FobPutStatus status;
+      status.fob_type = put.first;
+      try {
+        put.second.get();
+      }
+      catch(const std::exception& e) {
+        LOG(kError) << "Failed to store public " << put.first << ": " << e.what();
+        status.error = std::current_exception();
+      }
+      catch(...) {
+        LOG(kError) << "Failed to store public " << put.first;
+        status.error = std::current_exception();
+      }
+      statuses.push_back(status);
+    }
+    puts_.clear();
+    return statuses;
+  }
+
+ private:
+  PublicFobPublisher(const PublicFobPublisher&);
+  PublicFobPublisher& operator=(const PublicFobPublisher&);
+
+  ClientMaid& client_maid_;
+  const bool kConfirmed_;
+  const Pmid::Name kPmidName_;
+  std::vector<std::pair<const char*, std::future<void>>> puts_;
+};
+
+template<typename Duty>
+ClientMaid::FobPutStatuses ClientMaid::PutPublicFobs() {
+  LIFESTUFF_TRACE_SPAN("ClientMaid::PutPublicFobs");
+  PublicFobPublisher publisher(*this, detail::PublishedFobs<Duty>::kConfirmed);
+  detail::ForEachFob<typename detail::PublishedFobs<Duty>::type>::Apply(publisher);
+  return publisher.Wait();
 }
 
-void ClientMaid::PutPaidFobs() {
-  /*ReplyFunction reply([this] (maidsafe::nfs::Reply reply) {
-                        if (!reply.IsSuccess()) {
-                          ThrowError(VaultErrors::failed_to_handle_request);
-                        }
-                      });
-  detail::PutFobs<Paid>()(*storage_, session_.passport(), reply);*/
+void ClientMaid::RethrowFirstFailure(const FobPutStatuses& statuses) {
+  for (auto& status : statuses) {
+    if (status.error)
+      std::rethrow_exception(status.error);
+  }
+}
+
+void ClientMaid::PublicKeyRequest(const NodeId& node_id, const GivePublicKeyFunctor& give_key) {
+  public_key_cache_.Get(node_id, give_key);
 }
 
-void ClientMaid::PublicKeyRequest(const NodeId& /*node_id*/, const GivePublicKeyFunctor& /*give_key*/) {
+PublicKeyCache::KeyRecord ClientMaid::FetchPublicKey(const NodeId& node_id) {
+  if (network_) {
+    typedef passport::PublicPmid PublicPmid;
+    PublicPmid public_pmid(GetFob<PublicPmid>(PublicPmid::Name(Identity(node_id.string()))));
+    PublicKeyCache::KeyRecord record;
+    record.public_key = public_pmid.public_key();
+    record.validation_token = public_pmid.validation_token().string();
+    return record;
+  }
   /*if (storage_) {
     typedef passport::PublicPmid PublicPmid;
     PublicPmid::Name pmid_name(Identity(node_id.string()));
     auto pmid_future(maidsafe::nfs::Get<PublicPmid>(*storage_, pmid_name));
-    give_key(pmid_future.get()->public_key());
-  } else {
-    ThrowError(CommonErrors::uninitialised);
+    return pmid_future.get()->public_key();
   }*/
+  ThrowError(CommonErrors::uninitialised);
+  return PublicKeyCache::KeyRecord();
 }
 
 }  // lifestuff
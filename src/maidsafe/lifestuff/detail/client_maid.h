@@ -19,13 +19,31 @@
 #ifndef MAIDSAFE_LIFESTUFF_DETAIL_CLIENT_MAID_H_
 #define MAIDSAFE_LIFESTUFF_DETAIL_CLIENT_MAID_H_
 
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "maidsafe/data_store/sure_file_store.h"
 
 #include "maidsafe/routing/routing_api.h"
 
 #include "maidsafe/lifestuff/lifestuff.h"
 #include "maidsafe/lifestuff_manager/client_controller.h"
+#include "maidsafe/lifestuff/detail/bootstrap_cache.h"
+#include "maidsafe/lifestuff/detail/credential_rotation.h"
+#include "maidsafe/lifestuff/detail/executor.h"
+#include "maidsafe/lifestuff/detail/fob_pool.h"
+#include "maidsafe/lifestuff/detail/hedged_getter.h"
+#include "maidsafe/lifestuff/detail/join_race.h"
+#include "maidsafe/lifestuff/detail/network.h"
+#include "maidsafe/lifestuff/detail/phase_recorder.h"
+#include "maidsafe/lifestuff/detail/public_key_cache.h"
 #include "maidsafe/lifestuff/detail/session.h"
+#include "maidsafe/lifestuff/detail/session_cache.h"
 #include "maidsafe/lifestuff/detail/user_storage.h"
 #include "maidsafe/lifestuff/detail/routing_handler.h"
 
@@ -34,7 +52,6 @@ namespace lifestuff {
 
 class ClientMaid {
  public:
-  typedef std::unique_ptr<RoutingHandler> RoutingHandlerPtr;
   typedef RoutingHandler::EndPointVector EndPointVector;
 //  typedef nfs::PmidRegistration PmidRegistration;
   typedef lifestuff_manager::ClientController ClientController;
@@ -51,10 +68,16 @@ class ClientMaid {
   typedef passport::Pmid Pmid;
   typedef passport::Mid Mid;
   typedef passport::Tmid Tmid;
+  typedef std::unique_ptr<SessionCache> SessionCachePtr;
+  typedef std::unique_ptr<NonEmptyString> SerialisedSessionPtr;
 
-  ClientMaid(Session& session, const Slots& slots);
+  ClientMaid(Session& session,
+             const Slots& slots,
+             const ClientOptions& options = ClientOptions());
   ~ClientMaid();
 
+  // Starts pre-generating fobs for CreateUser (see FobPool::Start).
+  void PrepareCreateUser();
   void CreateUser(const Keyword& keyword,
                   const Pin& pin,
                   const Password& password,
@@ -88,35 +111,126 @@ class ClientMaid {
   boost::filesystem::path mount_path();
   boost::filesystem::path owner_path();
 
+  FobPool::Metrics fob_pool_metrics() const;
+  PublicKeyCache::Metrics public_key_cache_metrics() const;
+  HedgedGetter::Metrics hedged_getter_metrics() const;
+  // The executor running routing callbacks for every routing handler of this client, and other
+  // short tasks such as TMID prefetches and the public fob puts of CreateUser.
+  Executor& executor();
+  const Executor& executor() const;
+  // Outcome of the most recent race, see ClientOptions::racing_join.
+  JoinReport last_join_report() const;
+  const PhaseRecorder& phase_recorder() const;
+
+  // Serves joins, data and vault start-up through 'network' instead of routing, nfs and the vault
+  // manager, e.g. a LoopbackNetwork for offline benchmarks.  Must be called before CreateUser or
+  // LogIn.  UserStorage and the drive are not served by 'network': CreateUser then skips its drive
+  // check, and MountDrive throws.
+  void UseNetwork(std::shared_ptr<Network> network);
+
+  // When enabled, the encrypted session is also kept under kAppHomeDirectory so that later logins
+  // on this machine can start from it while the network copy is checked in the background.
+  void EnableSessionCache(bool enable);
+
  private:
 
   const Slots& CheckSlots(const Slots& slots);
 
-  void PutSession(const Keyword& keyword, const Pin& pin, const Password& password);
-  void DeleteSession(const Keyword& keyword, const Pin& pin;
+  // 'overwrite_mid' is true when a MID already exists for 'keyword' and 'pin'.
+  void PutSession(const Keyword& keyword,
+                  const Pin& pin,
+                  const Password& password,
+                  bool overwrite_mid);
+  // Re-stores the session under the current credentials if it has been modified.  Unless 'flush'
+  // is set, changes to used space alone are coalesced (see kUsedSpaceSaveInterval).
+  void SaveSession(bool flush);
+  void DeleteSession(const Mid::Name& mid_name, const Tmid::Name& tmid_name);
+  // Journals the old MID, stores the session under the new credentials and then deletes the old
+  // MID/TMID, so that an interrupted deletion is resumed at the next login.  Returns once the new
+  // credentials are stored; only a failure to store them fails the rotation.
+  void RotateSession(const Keyword& old_keyword,
+                     const Pin& old_pin,
+                     const Keyword& new_keyword,
+                     const Pin& new_pin,
+                     const Password& password);
+  // Also reaps deletions which have already finished.
+  void DeleteSessionAsync(const Mid::Name& mid_name, const Tmid::Name& tmid_name);
+  // Drops any journalled MID matching the current credentials: its rotation never completed.
+  void ResumeCredentialRotation();
+  void WaitForPendingDeletions();
+  RotationJournal& rotation_journal();
   void GetSession(const Keyword& keyword, const Pin& pin, const Password& password);
-
-  void JoinNetwork(const Maid& maid);
+  passport::EncryptedSession GetEncryptedSession(const Keyword& keyword, const Pin& pin);
+  bool GetCachedSession(const Keyword& keyword, const Pin& pin, const Password& password);
+  void RevalidateSession();
+  // Applies any newer session found by RevalidateSession, waiting for it if still running.
+  void ReconcileSession();
+
+  // If ClientOptions::racing_join is set, 'race' makes the join first race anonymous handlers, one
+  // per bootstrap endpoint (see RaceBootstrap).  Either way the winner of the last race, if any,
+  // is tried first, so later joins of the same operation pass false to reuse it.
+  void JoinNetwork(const Maid& maid, bool race);
+
+  // Created on first use, so that a client served by a Network never contacts the vault manager.
+  ClientController& client_controller();
+  void StartVault(const Pmid& pmid,
+                  const Maid::Name& account_name,
+                  const boost::filesystem::path& chunkstore);
 
   void RegisterPmid(const Maid& maid, const Pmid& pmid);
   void UnregisterPmid(const Maid& maid, const Pmid& pmid);
 
   void UnCreateUser(bool fobs_confirmed, bool drive_mounted);
 
-  template<typename Fob> void PutFob(const Fob& fob);
+  // 'pmid_name' is the PMID the put is charged to, which must come from the same passport state,
+  // confirmed or not, as 'fob'.
+  template<typename Fob> void PutFob(const Fob& fob, const Pmid::Name& pmid_name);
   template<typename Fob> void DeleteFob(const typename Fob::Name& fob_name);
   template<typename Fob> Fob GetFob(const typename Fob::Name& fob_name);
-  
-  void PutFreeFobs();
-  void PutPaidFobs();
+
+  // Outcome of storing one public fob.
+  struct FobPutStatus {
+    FobPutStatus() : fob_type(), error() {}
+    // As detail::PublicFob<Fob>::name(), e.g. "Anmaid".
+    std::string fob_type;
+    // Null if the fob was stored.
+    std::exception_ptr error;
+  };
+  typedef std::vector<FobPutStatus> FobPutStatuses;
+
+  // Stores the public parts of detail::PublishedFobs<Duty> concurrently on the executor, waiting
+  // for all of them, and returns the outcome of each.  Does not throw for a failed put.
+  template<typename Duty> FobPutStatuses PutPublicFobs();
+  static void RethrowFirstFailure(const FobPutStatuses& statuses);
+  class PublicFobPublisher;
 
   void PublicKeyRequest(const NodeId& node_id, const GivePublicKeyFunctor& give_key);
+  PublicKeyCache::KeyRecord FetchPublicKey(const NodeId& node_id);
 
   Slots slots_;
   Session& session_;
+  FobPool fob_pool_;
+  PhaseRecorder phase_recorder_;
+  SessionCachePtr session_cache_;
+  std::future<SerialisedSessionPtr> session_revalidation_;
+  std::chrono::steady_clock::time_point last_session_save_;
+  std::unique_ptr<RotationJournal> rotation_journal_;
+  std::mutex rotation_journal_mutex_;
+  std::vector<std::future<void>> pending_deletions_;
   ClientControllerPtr client_controller_;
+  std::mutex client_controller_mutex_;
   StoragePtr storage_;
+  std::shared_ptr<Network> network_;
+  std::unique_ptr<HedgedGetter> hedged_getter_;
   UserStorage user_storage_;
+  Executor executor_;
+  EndPointVector bootstrap_endpoints_;
+  BootstrapCache bootstrap_cache_;
+  PublicKeyCache public_key_cache_;
+  const bool kRacingJoin_;
+  std::vector<std::unique_ptr<Maid>> racer_maids_;
+  JoinReport last_join_report_;
+  mutable std::mutex join_report_mutex_;
   RoutingHandlerPtr routing_handler_;
 };
 
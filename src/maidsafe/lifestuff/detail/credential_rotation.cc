@@ -0,0 +1,125 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/credential_rotation.h"
+
+#include <algorithm>
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/rotation_journal.pb.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+RotationJournal::RotationJournal(const boost::filesystem::path& file_path)
+  : kFilePath_(file_path),
+    mutex_() {}
+
+void RotationJournal::Add(const Mid::Name& mid_name) {
+  Add(mid_name, Tmid::Name());
+}
+
+void RotationJournal::Add(const Mid::Name& mid_name, const Tmid::Name& tmid_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Entry> entries(Load());
+  auto itr(std::find_if(entries.begin(), entries.end(),
+                        [&mid_name](const Entry& entry) { return entry.first == mid_name; }));
+  if (itr == entries.end())
+    entries.push_back(std::make_pair(mid_name, tmid_name));
+  else
+    itr->second = tmid_name;
+  Save(entries);
+}
+
+void RotationJournal::Remove(const Mid::Name& mid_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Entry> entries(Load());
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [&mid_name](const Entry& entry) {
+                                 return entry.first == mid_name;
+                               }),
+                entries.end());
+  Save(entries);
+}
+
+std::vector<RotationJournal::Entry> RotationJournal::Entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Load();
+}
+
+std::vector<RotationJournal::Entry> RotationJournal::ResumableEntries(
+    const Mid::Name& live_mid_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Entry> entries(Load());
+  auto live(std::remove_if(entries.begin(), entries.end(),
+                           [&live_mid_name](const Entry& entry) {
+                             return entry.first == live_mid_name;
+                           }));
+  if (live != entries.end()) {
+    entries.erase(live, entries.end());
+    Save(entries);
+  }
+  return entries;
+}
+
+void RotationJournal::Save(const std::vector<Entry>& entries) const {
+  boost::system::error_code error_code;
+  if (entries.empty()) {
+    boost::filesystem::remove(kFilePath_, error_code);
+    return;
+  }
+  if (!boost::filesystem::exists(kFilePath_.parent_path(), error_code))
+    boost::filesystem::create_directories(kFilePath_.parent_path(), error_code);
+  RotationJournalData journal;
+  for (auto& entry : entries) {
+    auto journal_entry(journal.add_entries());
+    journal_entry->set_mid_name(entry.first.data.string());
+    if (entry.second.data.IsInitialised())
+      journal_entry->set_tmid_name(entry.second.data.string());
+  }
+  if (!WriteFile(kFilePath_, journal.SerializeAsString()))
+    ThrowError(CommonErrors::filesystem_io_error);
+}
+
+std::vector<RotationJournal::Entry> RotationJournal::Load() const {
+  std::vector<Entry> entries;
+  std::string content;
+  if (!ReadFile(kFilePath_, &content) || content.empty())
+    return entries;
+  RotationJournalData journal;
+  if (!journal.ParseFromString(content)) {
+    LOG(kError) << "Failed to parse credential rotation journal " << kFilePath_;
+    return entries;
+  }
+  for (auto& journal_entry : journal.entries()) {
+    entries.push_back(std::make_pair(Mid::Name(Identity(journal_entry.mid_name())),
+                                     journal_entry.has_tmid_name() ?
+                                         Tmid::Name(Identity(journal_entry.tmid_name())) :
+                                         Tmid::Name()));
+  }
+  return entries;
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,69 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_CREDENTIAL_ROTATION_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_CREDENTIAL_ROTATION_H_
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/passport/passport.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// Records the MID/TMID pairs made obsolete by a keyword or pin change until they have been deleted
+// from the network, so that deletions interrupted by a crash can be resumed at the next login.
+// A MID is added before the new credentials are stored, when its TMID's name may not be known yet;
+// such entries have an uninitialised TMID name.  One journal file is kept per account.
+class RotationJournal {
+ public:
+  typedef passport::Mid Mid;
+  typedef passport::Tmid Tmid;
+  typedef std::pair<Mid::Name, Tmid::Name> Entry;
+
+  explicit RotationJournal(const boost::filesystem::path& file_path);
+
+  // Adds or replaces the entry for 'mid_name'.
+  void Add(const Mid::Name& mid_name);
+  void Add(const Mid::Name& mid_name, const Tmid::Name& tmid_name);
+  void Remove(const Mid::Name& mid_name);
+  std::vector<Entry> Entries() const;
+  // Returns the entries whose deletion should be resumed by an account logged in with
+  // 'live_mid_name'.  An entry for that MID itself was journalled by a rotation which never stored
+  // its new credentials, so the MID is still live: the entry is removed rather than returned.
+  std::vector<Entry> ResumableEntries(const Mid::Name& live_mid_name);
+
+ private:
+  RotationJournal(const RotationJournal&);
+  RotationJournal& operator=(const RotationJournal&);
+
+  void Save(const std::vector<Entry>& entries) const;
+  std::vector<Entry> Load() const;
+
+  const boost::filesystem::path kFilePath_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_CREDENTIAL_ROTATION_H_
@@ -0,0 +1,159 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/executor.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+// Large enough for a posted task capturing a few pointers and shared pointers.
+const size_t kHandlerBlockSize(256);
+const size_t kMaxFreeHandlerBlocks(1024);
+
+uint64_t Microseconds(Executor::Clock::duration duration) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+void UpdateMax(std::atomic<uint64_t>& maximum, uint64_t value) {
+  uint64_t current(maximum.load());
+  while (value > current && !maximum.compare_exchange_weak(current, value)) {}
+}
+
+}  // unnamed namespace
+
+HandlerAllocator::HandlerAllocator() : free_blocks_(), mutex_() {}
+
+HandlerAllocator::~HandlerAllocator() {
+  for (auto block : free_blocks_)
+    ::operator delete(block);
+}
+
+void* HandlerAllocator::Allocate(size_t size) {
+  if (size <= kHandlerBlockSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_blocks_.empty()) {
+      void* block(free_blocks_.back());
+      free_blocks_.pop_back();
+      return block;
+    }
+    return ::operator new(kHandlerBlockSize);
+  }
+  return ::operator new(size);
+}
+
+void HandlerAllocator::Deallocate(void* pointer, size_t size) {
+  if (size <= kHandlerBlockSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_blocks_.size() < kMaxFreeHandlerBlocks) {
+      free_blocks_.push_back(pointer);
+      return;
+    }
+  }
+  ::operator delete(pointer);
+}
+
+Executor::Executor(const ExecutorOptions& options)
+    : handler_allocator_(),
+      io_service_(),
+      work_(new boost::asio::io_service::work(io_service_)),
+      threads_(),
+      queue_depth_(0),
+      max_queue_depth_(0),
+      completed_(0),
+      total_wait_(0),
+      max_wait_(0),
+      total_run_(0) {
+  uint32_t thread_count(options.thread_count);
+  if (thread_count == 0)
+    thread_count = std::max(1U, std::thread::hardware_concurrency());
+  for (uint32_t i(0); i != thread_count; ++i) {
+    threads_.push_back(std::thread([this] { io_service_.run(); }));
+    if (!options.cpu_affinity.empty())
+      PinToCpu(threads_.back(), options.cpu_affinity[i % options.cpu_affinity.size()]);
+  }
+}
+
+Executor::~Executor() {
+  work_.reset();
+  for (auto& thread : threads_) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      LOG(kError) << "Executor destroyed from one of its own tasks.";
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+}
+
+Executor::Metrics Executor::metrics() const {
+  Metrics metrics;
+  metrics.thread_count = static_cast<uint32_t>(threads_.size());
+  metrics.queue_depth = queue_depth_;
+  metrics.max_queue_depth = max_queue_depth_;
+  metrics.completed = completed_;
+  metrics.total_wait = total_wait_;
+  metrics.max_wait = max_wait_;
+  metrics.total_run = total_run_;
+  return metrics;
+}
+
+void Executor::PinToCpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  int result(pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set));
+  if (result != 0)
+    LOG(kWarning) << "Failed to pin executor thread to CPU " << cpu << ": error " << result;
+#else
+  static_cast<void>(thread);
+  LOG(kWarning) << "CPU affinity is not supported on this platform; ignoring CPU " << cpu;
+#endif
+}
+
+Executor::Clock::time_point Executor::Posted() {
+  UpdateMax(max_queue_depth_, ++queue_depth_);
+  return Clock::now();
+}
+
+Executor::Clock::time_point Executor::Started(Clock::time_point posted) {
+  --queue_depth_;
+  Clock::time_point now(Clock::now());
+  uint64_t wait(Microseconds(now - posted));
+  total_wait_ += wait;
+  UpdateMax(max_wait_, wait);
+  return now;
+}
+
+void Executor::Finished(Clock::time_point started) {
+  total_run_ += Microseconds(Clock::now() - started);
+  ++completed_;
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,151 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_EXECUTOR_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_EXECUTOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/asio/io_service.hpp"
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+struct ExecutorOptions {
+  ExecutorOptions() : thread_count(0), cpu_affinity() {}
+  // Zero means one thread per hardware thread.
+  uint32_t thread_count;
+  // If not empty, worker thread i is pinned to CPU cpu_affinity[i % cpu_affinity.size()].  Only
+  // honoured on Linux.
+  std::vector<int> cpu_affinity;
+};
+
+// Recycles fixed-size blocks of memory for the handlers posted to an Executor, so that posting a
+// task does not normally reach the global allocator.  Larger requests fall through to it.
+class HandlerAllocator {
+ public:
+  HandlerAllocator();
+  ~HandlerAllocator();
+
+  void* Allocate(size_t size);
+  void Deallocate(void* pointer, size_t size);
+
+ private:
+  HandlerAllocator(const HandlerAllocator&);
+  HandlerAllocator& operator=(const HandlerAllocator&);
+
+  std::vector<void*> free_blocks_;
+  std::mutex mutex_;
+};
+
+// Wraps a handler so that asio allocates its internal operation object from 'allocator'.
+template<typename Handler>
+class PooledHandler {
+ public:
+  PooledHandler(HandlerAllocator& allocator, Handler handler)
+      : allocator_(&allocator), handler_(std::move(handler)) {}
+
+  void operator()() { handler_(); }
+
+  friend void* asio_handler_allocate(size_t size, PooledHandler* self) {
+    return self->allocator_->Allocate(size);
+  }
+  friend void asio_handler_deallocate(void* pointer, size_t size, PooledHandler* self) {
+    self->allocator_->Deallocate(pointer, size);
+  }
+
+ private:
+  HandlerAllocator* allocator_;
+  Handler handler_;
+};
+
+// A pool of worker threads running tasks from a single shared queue, in which any idle worker takes
+// the next task.  A client's executor runs the callbacks of all its routing handlers and other
+// short tasks; work which blocks for long, such as key generation in FobPool or ClientImpl's queue
+// of user operations, keeps its own threads so as not to starve routing.  Tasks still queued when
+// the executor is destroyed are run before it returns.
+class Executor {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Metrics {
+    Metrics() : thread_count(0), queue_depth(0), max_queue_depth(0), completed(0),
+                total_wait(0), max_wait(0), total_run(0) {}
+    uint32_t thread_count;
+    // Tasks posted but not yet started.
+    uint64_t queue_depth, max_queue_depth;
+    uint64_t completed;
+    // Queueing delay and execution time of completed tasks, in microseconds.
+    uint64_t total_wait, max_wait, total_run;
+  };
+
+  explicit Executor(const ExecutorOptions& options);
+  ~Executor();
+
+  template<typename Functor>
+  void Post(Functor functor);
+
+  Metrics metrics() const;
+
+ private:
+  Executor(const Executor&);
+  Executor& operator=(const Executor&);
+
+  void PinToCpu(std::thread& thread, int cpu);
+  Clock::time_point Posted();
+  Clock::time_point Started(Clock::time_point posted);
+  void Finished(Clock::time_point started);
+
+  HandlerAllocator handler_allocator_;
+  boost::asio::io_service io_service_;
+  std::unique_ptr<boost::asio::io_service::work> work_;
+  std::vector<std::thread> threads_;
+  std::atomic<uint64_t> queue_depth_, max_queue_depth_, completed_, total_wait_, max_wait_,
+                        total_run_;
+};
+
+template<typename Functor>
+void Executor::Post(Functor functor) {
+  Clock::time_point posted(Posted());
+  auto task([this, posted, functor] {
+              Clock::time_point started(Started(posted));
+              try {
+                functor();
+              }
+              catch(const std::exception& e) {
+                LOG(kError) << "Executor task threw: " << e.what();
+              }
+              Finished(started);
+            });
+  io_service_.post(PooledHandler<decltype(task)>(handler_allocator_, std::move(task)));
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_EXECUTOR_H_
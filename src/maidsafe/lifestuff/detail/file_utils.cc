@@ -0,0 +1,51 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include "maidsafe/lifestuff/detail/file_utils.h"
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+bool ReplaceFile(const boost::filesystem::path& file_path, const std::string& content) {
+  boost::system::error_code error_code;
+  boost::filesystem::path directory(file_path.parent_path());
+  if (!directory.empty() && !boost::filesystem::exists(directory, error_code))
+    boost::filesystem::create_directories(directory, error_code);
+  boost::filesystem::path temp_path(file_path.string() + "." + RandomAlphaNumericString(8) +
+                                    ".tmp");
+  if (!WriteFile(temp_path, content)) {
+    boost::filesystem::remove(temp_path, error_code);
+    return false;
+  }
+  boost::filesystem::rename(temp_path, file_path, error_code);
+  if (error_code) {
+    LOG(kWarning) << "Failed to replace " << file_path << ": " << error_code.message();
+    boost::filesystem::remove(temp_path, error_code);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
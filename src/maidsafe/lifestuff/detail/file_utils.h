@@ -0,0 +1,39 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_FILE_UTILS_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_FILE_UTILS_H_
+
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// Writes 'content' to a uniquely named temporary file beside 'file_path' and then renames it over
+// 'file_path', so that a reader or a crash sees either the previous content or the new, never a
+// partial write.  Creates the parent directory if need be.  Returns false on failure, leaving any
+// previous file intact.
+bool ReplaceFile(const boost::filesystem::path& file_path, const std::string& content);
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_FILE_UTILS_H_
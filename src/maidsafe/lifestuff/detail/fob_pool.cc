@@ -0,0 +1,139 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/fob_pool.h"
+
+#include <algorithm>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+FobPool::PassportPtr CreatePassport() {
+  FobPool::PassportPtr passport(new passport::Passport());
+  passport->CreateFobs();
+  return passport;
+}
+
+}  // unnamed namespace
+
+FobPool::FobPool(size_t depth, uint32_t thread_count, Generator generator)
+  : kDepth_(depth),
+    kGenerator_(generator ? generator : Generator(CreatePassport)),
+    passports_(),
+    in_progress_(0),
+    started_(false),
+    stopped_(false),
+    hits_(0),
+    misses_(0),
+    waits_(0),
+    mutex_(),
+    generated_(),
+    asio_service_(std::max(thread_count, 1U)) {
+  asio_service_.Start();
+}
+
+FobPool::~FobPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  generated_.notify_all();
+  asio_service_.Stop();
+}
+
+void FobPool::Start() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_ = true;
+  }
+  Refill();
+}
+
+FobPool::PassportPtr FobPool::Take() {
+  PassportPtr passport;
+  bool waited(false);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // A passport already being generated is waited for; generating another here would only
+    // finish at about the same time and leave one unused.
+    if (passports_.empty() && in_progress_ != 0 && !stopped_) {
+      waited = true;
+      generated_.wait(lock, [this] {
+                        return !passports_.empty() || in_progress_ == 0 || stopped_;
+                      });
+    }
+    if (!passports_.empty()) {
+      passport = std::move(passports_.front());
+      passports_.pop_front();
+    }
+  }
+  Refill();
+  if (passport) {
+    if (waited)
+      ++waits_;
+    else
+      ++hits_;
+    return passport;
+  }
+  ++misses_;
+  LOG(kVerbose) << "Fob pool empty, creating fobs on caller's thread.";
+  return kGenerator_();
+}
+
+FobPool::Metrics FobPool::metrics() const {
+  Metrics metrics;
+  metrics.hits = hits_;
+  metrics.waits = waits_;
+  metrics.misses = misses_;
+  std::lock_guard<std::mutex> lock(mutex_);
+  metrics.ready = passports_.size();
+  return metrics;
+}
+
+void FobPool::Refill() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (started_ && !stopped_ && passports_.size() + in_progress_ < kDepth_) {
+    ++in_progress_;
+    asio_service_.service().post([this] { Generate(); });
+  }
+}
+
+void FobPool::Generate() {
+  PassportPtr passport;
+  try {
+    passport = kGenerator_();
+  }
+  catch(const std::exception& e) {
+    LOG(kError) << "Failed to pre-generate fobs: " << e.what();
+    passport.reset();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_progress_;
+    if (passport && !stopped_)
+      passports_.push_back(std::move(passport));
+  }
+  generated_.notify_all();
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
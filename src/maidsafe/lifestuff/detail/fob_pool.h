@@ -0,0 +1,95 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_FOB_POOL_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_FOB_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "maidsafe/common/asio_service.h"
+
+#include "maidsafe/passport/passport.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+const uint32_t kDefaultFobPoolThreads(1);
+
+// Keeps up to 'depth' passports with freshly created (unconfirmed) fobs ready for use, so that
+// account creation does not have to wait for RSA key generation.  Nothing is generated until
+// Start() is called, so clients which only log in never pay for key generation; from then on
+// passports are generated on a bounded pool of worker threads and the pool is topped up again each
+// time one is taken.
+class FobPool {
+ public:
+  typedef passport::Passport Passport;
+  typedef std::unique_ptr<Passport> PassportPtr;
+  // Returns a new passport on which CreateFobs() has been called.
+  typedef std::function<PassportPtr()> Generator;
+
+  struct Metrics {
+    Metrics() : hits(0), waits(0), misses(0), ready(0) {}
+    // Takes served by a ready passport, by one whose generation was in progress, and by creating
+    // one on the caller's thread, respectively.
+    uint64_t hits, waits, misses;
+    size_t ready;
+  };
+
+  // A 'depth' of zero disables pre-generation; Take() then always creates fobs on the caller's
+  // thread.  If 'generator' is empty, passports are created with Passport::CreateFobs().
+  FobPool(size_t depth, uint32_t thread_count, Generator generator = Generator());
+  ~FobPool();
+
+  // Starts pre-generating passports in the background.  Idempotent.
+  void Start();
+  // Returns a passport on which CreateFobs() has already been called.  Counts as a hit if one was
+  // ready, or as a wait if one was being generated, in which case it waits for that one rather
+  // than generating another.  Otherwise the fobs are created on the caller's thread and it counts
+  // as a miss.
+  PassportPtr Take();
+  Metrics metrics() const;
+
+ private:
+  FobPool(const FobPool&);
+  FobPool& operator=(const FobPool&);
+
+  void Refill();
+  void Generate();
+
+  const size_t kDepth_;
+  const Generator kGenerator_;
+  std::deque<PassportPtr> passports_;
+  size_t in_progress_;
+  bool started_, stopped_;
+  std::atomic<uint64_t> hits_, misses_;
+  std::atomic<uint64_t> waits_;
+  mutable std::mutex mutex_;
+  std::condition_variable generated_;
+  AsioService asio_service_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_FOB_POOL_H_
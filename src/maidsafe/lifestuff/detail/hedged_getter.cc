@@ -0,0 +1,254 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/hedged_getter.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+const size_t kMaxRoundTrips(256);
+
+}  // unnamed namespace
+
+struct HedgedGetter::Request {
+  Request() : mutex(), done(), succeeded(false), abandoned(false), content(), error(), pending(0),
+              winner(0) {}
+  std::mutex mutex;
+  std::condition_variable done;
+  // 'abandoned' is set once Get has given up, so that attempts still queued are skipped.
+  bool succeeded, abandoned;
+  NonEmptyString content;
+  std::exception_ptr error;
+  // Attempts queued or running.
+  uint32_t pending, winner;
+};
+
+struct HedgedGetter::State {
+  State(GetFunctor get_in, const HedgedGetOptions& options)
+      : kGet(get_in), kOptions(options), round_trips(), metrics(), queue(), running(0),
+        stopping(false), mutex(), work_available(), idle() {}
+  const GetFunctor kGet;
+  const HedgedGetOptions kOptions;
+  // Most recent successful round trip times, in microseconds.
+  std::deque<int64_t> round_trips;
+  Metrics metrics;
+  std::deque<std::function<void()>> queue;
+  uint32_t running;
+  bool stopping;
+  std::mutex mutex;
+  std::condition_variable work_available, idle;
+};
+
+HedgedGetter::HedgedGetter(GetFunctor get, const HedgedGetOptions& options)
+    : kOptions_(options),
+      state_(std::make_shared<State>(get, options)),
+      workers_() {
+  std::shared_ptr<State> state(state_);
+  for (uint32_t i(0); i != std::max(options.worker_threads, 1U); ++i)
+    workers_.push_back(std::thread([state] { Work(state); }));
+}
+
+HedgedGetter::~HedgedGetter() {
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->stopping = true;
+  state_->queue.clear();
+  state_->work_available.notify_all();
+  bool idle(state_->idle.wait_for(lock, kOptions_.shutdown_timeout,
+                                  [this] { return state_->running == 0; }));
+  if (!idle)
+    LOG(kWarning) << "Abandoning " << state_->running << " stalled get request(s).";
+  lock.unlock();
+  for (auto& worker : workers_) {
+    if (idle)
+      worker.join();
+    else
+      worker.detach();
+  }
+}
+
+NonEmptyString HedgedGetter::Get(const Identity& name) {
+  return Get(name, timeout());
+}
+
+NonEmptyString HedgedGetter::Get(const Identity& name, std::chrono::milliseconds deadline) {
+  Clock::time_point start(Clock::now());
+  Clock::time_point expiry(start + deadline);
+  Clock::duration delay(hedge_delay());
+  std::shared_ptr<Request> request(std::make_shared<Request>());
+  uint32_t launched(0);
+  Launch(request, name, launched++);
+
+  std::unique_lock<std::mutex> lock(request->mutex);
+  for (;;) {
+    bool can_hedge(launched <= kOptions_.max_hedges);
+    Clock::time_point wake(can_hedge ? std::min(expiry, start + delay * launched) : expiry);
+    request->done.wait_until(lock, wake, [request] {
+                               return request->succeeded || request->pending == 0;
+                             });
+    if (request->succeeded || request->pending == 0 || Clock::now() >= expiry || !can_hedge)
+      break;
+    lock.unlock();
+    Launch(request, name, launched++);
+    lock.lock();
+  }
+
+  bool succeeded(request->succeeded), failed(!succeeded && request->pending == 0);
+  uint32_t winner(request->winner);
+  std::exception_ptr error(request->error);
+  NonEmptyString content(request->content);
+  request->abandoned = true;
+  lock.unlock();
+
+  {
+    std::lock_guard<std::mutex> metrics_lock(state_->mutex);
+    ++state_->metrics.gets;
+    if (launched > 1)
+      ++state_->metrics.hedged;
+    if (succeeded && winner != 0)
+      ++state_->metrics.hedge_wins;
+    if (failed)
+      ++state_->metrics.failures;
+    else if (!succeeded)
+      ++state_->metrics.timeouts;
+  }
+
+  if (failed)
+    std::rethrow_exception(error);
+  if (!succeeded) {
+    LOG(kWarning) << "Get timed out after " << deadline.count() << "ms and " << launched
+                  << " request(s).";
+    ThrowError(CommonErrors::unable_to_handle_request);
+  }
+  return content;
+}
+
+std::chrono::milliseconds HedgedGetter::hedge_delay() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  std::chrono::milliseconds round_trip;
+  if (!Percentile(kOptions_.hedge_percentile, round_trip))
+    return kOptions_.initial_hedge_delay;
+  return std::max(round_trip, kOptions_.min_hedge_delay);
+}
+
+std::chrono::milliseconds HedgedGetter::timeout() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  std::chrono::milliseconds round_trip;
+  if (!Percentile(99, round_trip))
+    return kOptions_.initial_timeout;
+  return std::min(std::max(round_trip * kOptions_.timeout_multiplier, kOptions_.min_timeout),
+                  kOptions_.max_timeout);
+}
+
+HedgedGetter::Metrics HedgedGetter::metrics() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->metrics;
+}
+
+void HedgedGetter::Launch(std::shared_ptr<Request> request,
+                          const Identity& name,
+                          uint32_t attempt) {
+  {
+    std::lock_guard<std::mutex> lock(request->mutex);
+    ++request->pending;
+  }
+  std::shared_ptr<State> state(state_);
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->queue.push_back([state, request, name, attempt] {
+                            Attempt(state, request, name, attempt);
+                          });
+  state_->work_available.notify_one();
+}
+
+void HedgedGetter::Work(std::shared_ptr<State> state) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  for (;;) {
+    state->work_available.wait(lock, [state] { return state->stopping || !state->queue.empty(); });
+    if (state->stopping)
+      return;
+    std::function<void()> attempt(std::move(state->queue.front()));
+    state->queue.pop_front();
+    ++state->running;
+    lock.unlock();
+    attempt();
+    lock.lock();
+    --state->running;
+    state->idle.notify_all();
+  }
+}
+
+void HedgedGetter::Attempt(std::shared_ptr<State> state,
+                           std::shared_ptr<Request> request,
+                           const Identity& name,
+                           uint32_t attempt) {
+  {
+    std::lock_guard<std::mutex> lock(request->mutex);
+    if (request->succeeded || request->abandoned) {
+      --request->pending;
+      request->done.notify_all();
+      return;
+    }
+  }
+  Clock::time_point started(Clock::now());
+  NonEmptyString content;
+  std::exception_ptr error;
+  try {
+    content = state->kGet(name, attempt);
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->round_trips.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started).count());
+    if (state->round_trips.size() > kMaxRoundTrips)
+      state->round_trips.pop_front();
+  }
+  catch(...) {
+    error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(request->mutex);
+  --request->pending;
+  if (!error && !request->succeeded) {
+    request->succeeded = true;
+    request->content = content;
+    request->winner = attempt;
+  } else if (error) {
+    request->error = error;
+  }
+  request->done.notify_all();
+}
+
+bool HedgedGetter::Percentile(uint32_t percent, std::chrono::milliseconds& round_trip) const {
+  const std::deque<int64_t>& round_trips(state_->round_trips);
+  if (round_trips.empty() || round_trips.size() < kOptions_.min_samples)
+    return false;
+  std::vector<int64_t> samples(round_trips.begin(), round_trips.end());
+  size_t index((samples.size() - 1) * std::min(percent, 100U) / 100);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  round_trip = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::microseconds(samples[index]));
+  return true;
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,135 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_HEDGED_GETTER_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_HEDGED_GETTER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+struct HedgedGetOptions {
+  HedgedGetOptions()
+      : max_hedges(1),
+        hedge_percentile(95),
+        initial_hedge_delay(500),
+        min_hedge_delay(5),
+        initial_timeout(10000),
+        min_timeout(1000),
+        max_timeout(60000),
+        timeout_multiplier(4),
+        min_samples(20),
+        worker_threads(4),
+        shutdown_timeout(1000) {}
+  // Duplicate requests sent while the first is outstanding, one every hedge delay.
+  uint32_t max_hedges;
+  // The hedge delay is this percentile of observed get round trip times.
+  uint32_t hedge_percentile;
+  // Used until 'min_samples' round trips have been observed.
+  std::chrono::milliseconds initial_hedge_delay;
+  std::chrono::milliseconds min_hedge_delay;
+  // Gets without an explicit deadline time out after 'timeout_multiplier' times the 99th percentile
+  // round trip time, kept within ['min_timeout', 'max_timeout'], or 'initial_timeout' until
+  // 'min_samples' round trips have been observed.
+  std::chrono::milliseconds initial_timeout, min_timeout, max_timeout;
+  uint32_t timeout_multiplier;
+  size_t min_samples;
+  // Threads running requests.  Requests beyond this queue for a free thread, and a queued request
+  // whose get has already finished is skipped.
+  uint32_t worker_threads;
+  // How long destruction waits for running requests before abandoning them.
+  std::chrono::milliseconds shutdown_timeout;
+};
+
+// Bounds the time taken by blocking gets.  If a get has not returned within the hedge delay, a
+// duplicate is sent to another holder and whichever succeeds first is used; the others are left to
+// finish in the background and only contribute to the round trip statistics.
+//
+// Only ClientMaid's Network path (see ClientMaid::UseNetwork) uses this for now; the nfs get path
+// is to be wired in once it is restored.
+class HedgedGetter {
+ public:
+  // Asks holder number 'holder' of the data for it; the n-th duplicate of a get asks holder n.
+  // Runs on the getter's threads, possibly after the getter has been destroyed (see
+  // ~HedgedGetter), so it must only use state it shares ownership of.
+  typedef std::function<NonEmptyString(const Identity& name, uint32_t holder)> GetFunctor;
+  typedef std::chrono::steady_clock Clock;
+
+  struct Metrics {
+    Metrics() : gets(0), hedged(0), hedge_wins(0), timeouts(0), failures(0) {}
+    uint64_t gets;
+    // Gets which sent at least one duplicate request.
+    uint64_t hedged;
+    // Gets answered by a duplicate rather than the original request.
+    uint64_t hedge_wins;
+    uint64_t timeouts, failures;
+  };
+
+  HedgedGetter(GetFunctor get, const HedgedGetOptions& options);
+  // Discards queued requests and waits up to 'shutdown_timeout' for running ones.  Any still
+  // running after that are abandoned: their threads are detached and exit once their get returns.
+  ~HedgedGetter();
+
+  // Throws CommonErrors::unable_to_handle_request if 'deadline' passes first, otherwise rethrows
+  // the error of the last request to fail if none succeeds.
+  NonEmptyString Get(const Identity& name, std::chrono::milliseconds deadline);
+  // As above, with an adaptive deadline (see HedgedGetOptions).
+  NonEmptyString Get(const Identity& name);
+
+  std::chrono::milliseconds hedge_delay() const;
+  std::chrono::milliseconds timeout() const;
+  Metrics metrics() const;
+
+ private:
+  HedgedGetter(const HedgedGetter&);
+  HedgedGetter& operator=(const HedgedGetter&);
+
+  struct Request;
+  // Shared with the worker threads, which may outlive the getter.
+  struct State;
+
+  void Launch(std::shared_ptr<Request> request, const Identity& name, uint32_t attempt);
+  static void Work(std::shared_ptr<State> state);
+  static void Attempt(std::shared_ptr<State> state,
+                      std::shared_ptr<Request> request,
+                      const Identity& name,
+                      uint32_t attempt);
+  // Must be called with the state's mutex locked.
+  bool Percentile(uint32_t percent, std::chrono::milliseconds& round_trip) const;
+
+  const HedgedGetOptions kOptions_;
+  std::shared_ptr<State> state_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_HEDGED_GETTER_H_
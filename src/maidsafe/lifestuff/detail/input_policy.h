@@ -0,0 +1,97 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_INPUT_POLICY_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_INPUT_POLICY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "boost/regex.hpp"
+
+#include "maidsafe/lifestuff/lifestuff.h"
+#include "maidsafe/lifestuff/detail/session.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace detail {
+
+// Validation rules for each user input type, applied to the characters of every insertion so that
+// keystroke-level checks need neither the regex engine nor any allocation.
+template <typename Input>
+struct InputPolicy;
+
+struct PrintableCharacters {
+  static bool IsValidCharacter(char character) {
+    return static_cast<unsigned char>(character) >= 0x20 && character != 0x7f;
+  }
+};
+
+template <>
+struct InputPolicy<Keyword> : PrintableCharacters {
+  static const uint32_t kMaxSize = 100;
+};
+
+template <>
+struct InputPolicy<Password> : PrintableCharacters {
+  static const uint32_t kMaxSize = 100;
+};
+
+template <>
+struct InputPolicy<Pin> {
+  static const uint32_t kMaxSize = 10;
+  static bool IsValidCharacter(char character) { return character >= '0' && character <= '9'; }
+};
+
+// Checks inserting 'characters' at 'position' into an input currently holding 'current_size'
+// characters.  Keystrokes may arrive out of order, so 'position' may lie beyond the current end;
+// it is only bounded by the maximum size, as is the total size after the insertion.
+template <typename Input>
+bool IsValidInsertion(uint32_t current_size, uint32_t position, const std::string& characters) {
+  typedef InputPolicy<Input> Policy;
+  if (characters.size() > Policy::kMaxSize || position > Policy::kMaxSize - characters.size() ||
+      current_size > Policy::kMaxSize - characters.size())
+    return false;
+  for (char character : characters) {
+    if (!Policy::IsValidCharacter(character))
+      return false;
+  }
+  return true;
+}
+
+// Checks removing 'length' characters from 'position' of an input currently holding 'current_size'
+// characters.
+inline bool IsValidRemoval(uint32_t current_size, uint32_t position, uint32_t length) {
+  return position <= current_size && length <= current_size - position;
+}
+
+// The input strings only expose their own size checks via a regex, so one is compiled per input
+// type, once.  Its character class is already guaranteed by IsValidInsertion.
+template <typename Input>
+const boost::regex& ConfirmationRegex() {
+  static const boost::regex kRegex(kCharRegex);
+  return kRegex;
+}
+
+}  // namespace detail
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_INPUT_POLICY_H_
@@ -0,0 +1,117 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/join_race.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/lifestuff/detail/trace.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+std::chrono::milliseconds Elapsed(Clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since);
+}
+
+// Shared with the attempts' callbacks, which may still run after the race has finished.
+struct Race {
+  Race() : mutex(), condition_variable(), attempts(), winner(-1) {}
+  std::mutex mutex;
+  std::condition_variable condition_variable;
+  std::vector<JoinReport::Attempt> attempts;
+  int winner;
+};
+
+}  // unnamed namespace
+
+bool RaceBootstrap(const RacerFactory& make_racer,
+                   const RoutingHandler::EndPointVector& endpoints,
+                   const RoutingHandler::JoinObservers& join_observers,
+                   JoinReport& join_report) {
+  LIFESTUFF_TRACE_SPAN("RaceBootstrap");
+  std::shared_ptr<Race> race(std::make_shared<Race>());
+  std::vector<JoinRacerPtr> racers;
+  Clock::time_point start(Clock::now());
+  Clock::time_point deadline(start + kJoinRaceTimeout);
+  size_t width(std::min(endpoints.size(), kJoinRaceWidth));
+
+  std::unique_lock<std::mutex> lock(race->mutex);
+  for (size_t i(0); i != width && race->winner < 0; ++i) {
+    if (i != 0) {
+      Clock::time_point next_start(std::min(Clock::time_point(Clock::now() + kJoinRaceStagger),
+                                            deadline));
+      race->condition_variable.wait_until(lock, next_start, [race] { return race->winner >= 0; });
+      if (race->winner >= 0 || Clock::now() >= deadline)
+        break;
+    }
+    JoinReport::Attempt attempt;
+    attempt.endpoint = endpoints[i];
+    attempt.started_after = Elapsed(start);
+    race->attempts.push_back(attempt);
+
+    RoutingHandler::JoinObservers attempt_observers;
+    attempt_observers.new_bootstrap_endpoint = join_observers.new_bootstrap_endpoint;
+    int index(static_cast<int>(i));
+    attempt_observers.joined = [race, index](std::chrono::milliseconds join_time) {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->attempts[index].join_time = join_time;
+        race->attempts[index].joined = true;
+        if (race->winner >= 0)
+          return;
+        race->winner = index;
+        race->condition_variable.notify_all();
+      };
+    lock.unlock();
+    racers.push_back(make_racer(i));
+    racers.back()->Join(RoutingHandler::EndPointVector(1, endpoints[i]), attempt_observers);
+    lock.lock();
+  }
+  race->condition_variable.wait_until(lock, deadline, [race] { return race->winner >= 0; });
+
+  for (auto& attempt : race->attempts) {
+    if (!attempt.joined)
+      attempt.join_time = Elapsed(start) - attempt.started_after;
+  }
+  join_report.attempts = race->attempts;
+  join_report.winner = race->winner;
+  lock.unlock();
+
+  // Destroying the racers cancels any joins still in progress.
+  racers.clear();
+  if (join_report.winner >= 0) {
+    LOG(kInfo) << "Bootstrapped via " << join_report.attempts[join_report.winner].endpoint.first
+               << ':' << join_report.attempts[join_report.winner].endpoint.second << " in "
+               << join_report.attempts[join_report.winner].join_time.count() << "ms after "
+               << join_report.attempts.size() << " attempt(s).";
+    return true;
+  }
+  LOG(kWarning) << "No bootstrap attempt succeeded within " << kJoinRaceTimeout.count() << "ms.";
+  return false;
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
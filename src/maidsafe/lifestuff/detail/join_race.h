@@ -0,0 +1,82 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_JOIN_RACE_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_JOIN_RACE_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "maidsafe/lifestuff/detail/routing_handler.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+const size_t kJoinRaceWidth(4);
+const std::chrono::milliseconds kJoinRaceStagger(250);
+const std::chrono::milliseconds kJoinRaceTimeout(10000);
+
+struct JoinReport {
+  struct Attempt {
+    Attempt() : endpoint(), started_after(0), join_time(0), joined(false) {}
+    RoutingHandler::EndPoint endpoint;
+    // Delay from the start of the race until this attempt was started.
+    std::chrono::milliseconds started_after;
+    // Time taken to join, if 'joined', else the time the attempt ran before being cancelled.
+    std::chrono::milliseconds join_time;
+    bool joined;
+  };
+  JoinReport() : attempts(), winner(-1) {}
+  std::vector<Attempt> attempts;
+  // Index into 'attempts', or -1 if no attempt joined in time.
+  int winner;
+};
+
+typedef std::unique_ptr<RoutingHandler> RoutingHandlerPtr;
+
+// One attempt of a race, e.g. a RoutingHandler under a throwaway identity.  Destroying a racer
+// cancels its join if still in progress.
+class JoinRacer {
+ public:
+  virtual ~JoinRacer() {}
+  virtual void Join(const RoutingHandler::EndPointVector& endpoints,
+                    const RoutingHandler::JoinObservers& join_observers) = 0;
+};
+
+typedef std::unique_ptr<JoinRacer> JoinRacerPtr;
+// Returns the racer with the given index.  Each racer must have its own identity, distinct from
+// the client's and from the other racers', e.g. an anonymous Maid, since routing does not allow
+// one NodeId to join more than once at a time.
+typedef std::function<JoinRacerPtr(size_t racer)> RacerFactory;
+
+// Bootstraps via each of 'endpoints' on a separate racer, starting a new attempt every
+// kJoinRaceStagger until one joins, at most kJoinRaceWidth in all.  The racers are only probes:
+// all of them, including the winner, are destroyed before returning, and the caller then joins
+// under its own identity via the winning endpoint.  Returns false if none joined within
+// kJoinRaceTimeout.  join_observers.joined is not called.
+bool RaceBootstrap(const RacerFactory& make_racer,
+                   const RoutingHandler::EndPointVector& endpoints,
+                   const RoutingHandler::JoinObservers& join_observers,
+                   JoinReport& join_report);
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_JOIN_RACE_H_
@@ -0,0 +1,176 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include "maidsafe/lifestuff/detail/loopback_network.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+LoopbackNetwork::LoopbackNetwork(const LoopbackNetworkOptions& options)
+    : kOptions_(options),
+      data_(),
+      upload_free_(),
+      download_free_(),
+      request_counts_(),
+      metrics_(),
+      mutex_() {}
+
+void LoopbackNetwork::Join(const NodeId& node_id) {
+  Clock::time_point started(Clock::now());
+  std::mt19937 random(RequestRandom(kJoin, node_id.string(), 0));
+  Deliver(kUpload, 0, started, random);
+  Deliver(kDownload, 0, started, random);
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++metrics_.joins;
+}
+
+void LoopbackNetwork::Put(const Identity& name, const NonEmptyString& content) {
+  Clock::time_point started(Clock::now());
+  std::mt19937 random(RequestRandom(kPut, name.string(), 0));
+  Deliver(kUpload, content.string().size(), started, random);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_[name] = content;
+    ++metrics_.puts;
+  }
+  Deliver(kDownload, 0, started, random);
+}
+
+NonEmptyString LoopbackNetwork::Get(const Identity& name, uint32_t holder) {
+  Clock::time_point started(Clock::now());
+  std::mt19937 random(RequestRandom(kGet, name.string(), holder));
+  Deliver(kUpload, 0, started, random);
+  NonEmptyString content;
+  bool found(false);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++metrics_.gets;
+    auto itr(data_.find(name));
+    if (itr != data_.end()) {
+      content = itr->second;
+      found = true;
+    }
+  }
+  Deliver(kDownload, found ? content.string().size() : 0, started, random);
+  if (!found)
+    ThrowError(CommonErrors::no_such_element);
+  return content;
+}
+
+void LoopbackNetwork::Delete(const Identity& name) {
+  Clock::time_point started(Clock::now());
+  std::mt19937 random(RequestRandom(kDelete, name.string(), 0));
+  Deliver(kUpload, 0, started, random);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_.erase(name);
+    ++metrics_.deletes;
+  }
+  Deliver(kDownload, 0, started, random);
+}
+
+void LoopbackNetwork::StartVault(const passport::Pmid& pmid,
+                                 const passport::Maid::Name& /*account_name*/,
+                                 const boost::filesystem::path& /*chunkstore*/) {
+  // Stands for the round trip to the local vault manager; the vault itself is not simulated.
+  Clock::time_point started(Clock::now());
+  std::mt19937 random(RequestRandom(kStartVault, pmid.name().data.string(), 0));
+  Deliver(kUpload, 0, started, random);
+  Deliver(kDownload, 0, started, random);
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++metrics_.vaults_started;
+}
+
+size_t LoopbackNetwork::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return data_.size();
+}
+
+LoopbackNetwork::Metrics LoopbackNetwork::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+std::mt19937 LoopbackNetwork::RequestRandom(Request request,
+                                            const std::string& name,
+                                            uint32_t holder) {
+  uint32_t count(0);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count = request_counts_[std::make_tuple(request, name, holder)]++;
+  }
+  std::vector<uint32_t> seeds;
+  seeds.push_back(kOptions_.seed);
+  seeds.push_back(static_cast<uint32_t>(request));
+  seeds.push_back(holder);
+  seeds.push_back(count);
+  for (size_t i(0); i < name.size(); i += 4) {
+    uint32_t word(0);
+    for (size_t j(i); j != std::min(i + 4, name.size()); ++j)
+      word = (word << 8) | static_cast<unsigned char>(name[j]);
+    seeds.push_back(word);
+  }
+  std::seed_seq seed_sequence(seeds.begin(), seeds.end());
+  return std::mt19937(seed_sequence);
+}
+
+void LoopbackNetwork::Deliver(Direction direction,
+                              size_t bytes,
+                              Clock::time_point request_started,
+                              std::mt19937& random) {
+  std::uniform_int_distribution<int64_t> jitter(0, kOptions_.hop_jitter.count());
+  std::chrono::microseconds delay(0);
+  for (uint32_t hop(0); hop != kOptions_.hops; ++hop)
+    delay += kOptions_.hop_latency + std::chrono::microseconds(jitter(random));
+  bool lost(std::bernoulli_distribution(kOptions_.loss)(random));
+
+  Clock::time_point arrival(Clock::now());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (kOptions_.bandwidth != 0) {
+      // The message is queued behind those already using this direction of the link.
+      Clock::time_point& link_free(direction == kUpload ? upload_free_ : download_free_);
+      link_free = std::max(link_free, arrival) +
+                  std::chrono::microseconds(bytes * 1000000 / kOptions_.bandwidth);
+      arrival = link_free;
+    }
+    arrival += delay;
+    if (lost)
+      ++metrics_.lost;
+    else if (direction == kUpload)
+      metrics_.bytes_sent += bytes;
+    else
+      metrics_.bytes_received += bytes;
+  }
+
+  if (lost) {
+    std::this_thread::sleep_until(request_started + kOptions_.timeout);
+    ThrowError(CommonErrors::unable_to_handle_request);
+  }
+  std::this_thread::sleep_until(arrival);
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,96 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_LOOPBACK_NETWORK_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_LOOPBACK_NETWORK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <tuple>
+
+#include "maidsafe/lifestuff/lifestuff.h"
+#include "maidsafe/lifestuff/detail/network.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// An in-process stand-in for the network and the vault manager: data is held in memory, vaults are
+// not actually started, and each request is delayed (or dropped) according to the options.
+// Thread-safe.
+class LoopbackNetwork : public Network {
+ public:
+  struct Metrics {
+    Metrics() : joins(0), puts(0), gets(0), deletes(0), vaults_started(0), lost(0), bytes_sent(0),
+                bytes_received(0) {}
+    uint64_t joins, puts, gets, deletes, vaults_started;
+    // Requests which failed because a message was lost.
+    uint64_t lost;
+    uint64_t bytes_sent, bytes_received;
+  };
+
+  explicit LoopbackNetwork(const LoopbackNetworkOptions& options);
+
+  virtual void Join(const NodeId& node_id);
+  virtual void Put(const Identity& name, const NonEmptyString& content);
+  // Each holder's response is delayed and lost independently of the others'.
+  virtual NonEmptyString Get(const Identity& name, uint32_t holder);
+  virtual void Delete(const Identity& name);
+  virtual void StartVault(const passport::Pmid& pmid,
+                          const passport::Maid::Name& account_name,
+                          const boost::filesystem::path& chunkstore);
+
+  size_t size() const;
+  Metrics metrics() const;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+  enum Direction { kUpload, kDownload };
+  enum Request { kJoin, kPut, kGet, kDelete, kStartVault };
+
+  LoopbackNetwork(const LoopbackNetwork&);
+  LoopbackNetwork& operator=(const LoopbackNetwork&);
+
+  // Returns the generator for the jitter and loss of a request, see LoopbackNetworkOptions::seed.
+  // 'holder' is only meaningful for gets.
+  std::mt19937 RequestRandom(Request request, const std::string& name, uint32_t holder);
+  // Blocks while a message of 'bytes' crosses the network.  If it is lost, blocks until the
+  // request's timeout and throws.
+  void Deliver(Direction direction,
+               size_t bytes,
+               Clock::time_point request_started,
+               std::mt19937& random);
+
+  const LoopbackNetworkOptions kOptions_;
+  std::map<Identity, NonEmptyString> data_;
+  // When each direction of the client's link is next free, if its bandwidth is limited.
+  Clock::time_point upload_free_, download_free_;
+  // Number of requests so far of each type, name and holder.
+  std::map<std::tuple<Request, std::string, uint32_t>, uint32_t> request_counts_;
+  Metrics metrics_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_LOOPBACK_NETWORK_H_
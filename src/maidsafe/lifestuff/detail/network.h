@@ -0,0 +1,58 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_NETWORK_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_NETWORK_H_
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/passport/passport.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// The network and vault operations needed by ClientMaid, so that they can be served by something
+// other than routing, nfs and the vault manager, e.g. LoopbackNetwork for offline benchmarks and
+// load tests.  Each call blocks until the operation completes and throws on failure.  Data is
+// identified by its raw name, which is a hash and so unique across data types.
+class Network {
+ public:
+  virtual ~Network() {}
+
+  virtual void Join(const NodeId& node_id) = 0;
+  virtual void Put(const Identity& name, const NonEmptyString& content) = 0;
+  // Asks holder number 'holder' of the data, so that a duplicate request (see HedgedGetter) is
+  // served independently of the first.  Throws CommonErrors::no_such_element if 'name' is not
+  // stored.
+  virtual NonEmptyString Get(const Identity& name, uint32_t holder) = 0;
+  // Deleting data which is not stored is not an error.
+  virtual void Delete(const Identity& name) = 0;
+  // As lifestuff_manager::ClientController::StartVault.
+  virtual void StartVault(const passport::Pmid& pmid,
+                          const passport::Maid::Name& account_name,
+                          const boost::filesystem::path& chunkstore) = 0;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_NETWORK_H_
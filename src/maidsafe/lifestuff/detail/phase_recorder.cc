@@ -0,0 +1,123 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/phase_recorder.h"
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+const size_t kMaxSamplesPerPhase(1000);
+
+int64_t Percentile(std::vector<int64_t>& samples, size_t percent) {
+  size_t index((samples.size() - 1) * percent / 100);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+}  // unnamed namespace
+
+PhaseRecorder::Scope::Scope(PhaseRecorder& recorder, ReportProgressFunction& report_progress)
+  : recorder_(recorder),
+    report_progress_(report_progress),
+    in_phase_(false),
+    action_(),
+    progress_code_(),
+    occurrence_(0),
+    occurrences_(),
+    start_() {}
+
+PhaseRecorder::Scope::~Scope() {
+  EndPhase(std::uncaught_exception());
+}
+
+void PhaseRecorder::Scope::operator()(Action action, ProgressCode progress_code) {
+  EndPhase(false);
+  in_phase_ = true;
+  action_ = action;
+  progress_code_ = progress_code;
+  occurrence_ = occurrences_[std::make_pair(action, progress_code)]++;
+  start_ = Clock::now();
+  report_progress_(action, progress_code);
+}
+
+void PhaseRecorder::Scope::EndPhase(bool failed) {
+  if (!in_phase_)
+    return;
+  recorder_.Record(action_, progress_code_, occurrence_, failed, Clock::now() - start_);
+  in_phase_ = false;
+}
+
+PhaseRecorder::PhaseRecorder() : samples_(), counts_(), mutex_() {}
+
+void PhaseRecorder::Record(Action action,
+                           ProgressCode progress_code,
+                           uint32_t occurrence,
+                           bool failed,
+                           Clock::duration duration) {
+  Phase phase(action, progress_code, occurrence, failed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::deque<int64_t>& samples(samples_[phase]);
+  samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  if (samples.size() > kMaxSamplesPerPhase)
+    samples.pop_front();
+  ++counts_[phase];
+}
+
+std::vector<PhaseStatistics> PhaseRecorder::Statistics() const {
+  std::vector<PhaseStatistics> statistics;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& phase_samples : samples_) {
+    std::vector<int64_t> samples(phase_samples.second.begin(), phase_samples.second.end());
+    PhaseStatistics phase_statistics;
+    phase_statistics.action = std::get<0>(phase_samples.first);
+    phase_statistics.progress_code = std::get<1>(phase_samples.first);
+    phase_statistics.occurrence = std::get<2>(phase_samples.first);
+    phase_statistics.failed = std::get<3>(phase_samples.first);
+    phase_statistics.count = counts_.at(phase_samples.first);
+    phase_statistics.p50 = Percentile(samples, 50);
+    phase_statistics.p95 = Percentile(samples, 95);
+    phase_statistics.p99 = Percentile(samples, 99);
+    statistics.push_back(phase_statistics);
+  }
+  return statistics;
+}
+
+void PhaseRecorder::WriteToFile(const boost::filesystem::path& file_path) const {
+  std::ostringstream content;
+  content << "action,progress_code,occurrence,failed,count,p50_us,p95_us,p99_us\n";
+  for (auto& phase_statistics : Statistics()) {
+    content << phase_statistics.action << ',' << phase_statistics.progress_code << ','
+            << phase_statistics.occurrence << ',' << phase_statistics.failed << ','
+            << phase_statistics.count << ',' << phase_statistics.p50 << ','
+            << phase_statistics.p95 << ',' << phase_statistics.p99 << '\n';
+  }
+  if (!WriteFile(file_path, content.str()))
+    ThrowError(CommonErrors::filesystem_io_error);
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,96 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_PHASE_RECORDER_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_PHASE_RECORDER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/lifestuff/lifestuff.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// Keeps the most recent latency samples of each Action/ProgressCode phase.  A progress code
+// reported more than once in a call is recorded once per occurrence, and the phase a call failed in
+// is recorded separately from successful ones.
+class PhaseRecorder {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Forwards progress reports for a single call to 'report_progress', timing each phase from its
+  // report until the next one, or until the scope ends for the final phase.  If the scope ends
+  // through an exception, the final phase is recorded as failed.
+  class Scope {
+   public:
+    Scope(PhaseRecorder& recorder, ReportProgressFunction& report_progress);
+    ~Scope();
+    void operator()(Action action, ProgressCode progress_code);
+
+   private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+
+    void EndPhase(bool failed);
+
+    PhaseRecorder& recorder_;
+    ReportProgressFunction& report_progress_;
+    bool in_phase_;
+    Action action_;
+    ProgressCode progress_code_;
+    uint32_t occurrence_;
+    std::map<std::pair<Action, ProgressCode>, uint32_t> occurrences_;
+    Clock::time_point start_;
+  };
+
+  PhaseRecorder();
+
+  void Record(Action action,
+              ProgressCode progress_code,
+              uint32_t occurrence,
+              bool failed,
+              Clock::duration duration);
+  std::vector<PhaseStatistics> Statistics() const;
+  // Writes one line per phase: action, progress code, occurrence, failed, count, p50, p95, p99
+  // (microseconds).
+  void WriteToFile(const boost::filesystem::path& file_path) const;
+
+ private:
+  PhaseRecorder(const PhaseRecorder&);
+  PhaseRecorder& operator=(const PhaseRecorder&);
+
+  typedef std::tuple<Action, ProgressCode, uint32_t, bool> Phase;
+
+  std::map<Phase, std::deque<int64_t>> samples_;
+  std::map<Phase, uint64_t> counts_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_PHASE_RECORDER_H_
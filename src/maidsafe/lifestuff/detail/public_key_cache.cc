@@ -0,0 +1,266 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include "maidsafe/lifestuff/detail/public_key_cache.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/file_utils.h"
+#include "maidsafe/lifestuff/detail/public_key_cache.pb.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace {
+
+int64_t Now() {
+  return GetDurationSinceEpoch().total_milliseconds();
+}
+
+// Serialises the read, merge and write of saves by different caches in this process, so that
+// neither drops the other's keys.
+std::mutex save_mutex;
+
+ExecutorOptions FetchExecutorOptions(const PublicKeyCacheOptions& options) {
+  ExecutorOptions executor_options;
+  executor_options.thread_count = std::max(options.fetch_threads, 1U);
+  return executor_options;
+}
+
+bool MatchesNodeId(const NodeId& node_id, const PublicKeyCache::KeyRecord& record) {
+  try {
+    std::string encoded_key(asymm::EncodeKey(record.public_key).string());
+    return crypto::Hash<crypto::SHA512>(encoded_key + record.validation_token).string() ==
+           node_id.string();
+  }
+  catch(const std::exception&) {
+    return false;
+  }
+}
+
+}  // unnamed namespace
+
+PublicKeyCache::PublicKeyCache(FetchFunctor fetch, const PublicKeyCacheOptions& options)
+    : kFetch_(fetch),
+      kOptions_(options),
+      entries_(),
+      recency_(),
+      in_flight_(),
+      running_fetches_(0),
+      metrics_(),
+      mutex_(),
+      fetches_done_(),
+      fetch_executor_(FetchExecutorOptions(options)) {
+  Load();
+}
+
+PublicKeyCache::~PublicKeyCache() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  fetches_done_.wait(lock, [this] { return running_fetches_ == 0; });
+}
+
+void PublicKeyCache::Get(const NodeId& node_id, const GiveKeyFunctor& give_key) {
+  asymm::PublicKey public_key;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto itr(entries_.find(node_id));
+    if (itr == entries_.end() || itr->second.expiry <= Now()) {
+      ++metrics_.misses;
+      std::vector<GiveKeyFunctor>& waiters(in_flight_[node_id]);
+      waiters.push_back(give_key);
+      if (waiters.size() > 1) {
+        ++metrics_.coalesced;
+        return;
+      }
+      ++running_fetches_;
+      fetch_executor_.Post([this, node_id] { Fetch(node_id); });
+      return;
+    }
+    ++metrics_.hits;
+    recency_.splice(recency_.begin(), recency_, itr->second.recency);
+    public_key = itr->second.record.public_key;
+  }
+  give_key(public_key);
+}
+
+void PublicKeyCache::Remove(const NodeId& node_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr(entries_.find(node_id));
+  if (itr == entries_.end())
+    return;
+  recency_.erase(itr->second.recency);
+  entries_.erase(itr);
+}
+
+void PublicKeyCache::Save() const {
+  if (kOptions_.file_path.empty())
+    return;
+  std::lock_guard<std::mutex> save_lock(save_mutex);
+  PublicKeyCacheData cache;
+  int64_t now(Now());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& node_id : recency_) {
+      const Entry& entry(entries_.at(node_id));
+      if (entry.expiry <= now)
+        continue;
+      try {
+        std::string encoded_key(asymm::EncodeKey(entry.record.public_key).string());
+        auto cache_entry(cache.add_entries());
+        cache_entry->set_node_id(node_id.string());
+        cache_entry->set_public_key(encoded_key);
+        cache_entry->set_validation_token(entry.record.validation_token);
+        cache_entry->set_expiry(entry.expiry);
+      }
+      catch(const std::exception& e) {
+        LOG(kWarning) << "Not saving public key of " << DebugId(node_id) << ": " << e.what();
+      }
+    }
+  }
+  // Keys saved by other clients are carried over unchecked; Load checks every entry anyway.
+  std::string content;
+  PublicKeyCacheData saved;
+  if (ReadFile(kOptions_.file_path, &content) && !content.empty() &&
+      saved.ParseFromString(content)) {
+    std::set<std::string> included;
+    for (auto& cache_entry : cache.entries())
+      included.insert(cache_entry.node_id());
+    for (auto& saved_entry : saved.entries()) {
+      if (static_cast<size_t>(cache.entries_size()) >= kOptions_.capacity)
+        break;
+      if (saved_entry.expiry() > now && included.insert(saved_entry.node_id()).second)
+        *cache.add_entries() = saved_entry;
+    }
+  }
+  if (!ReplaceFile(kOptions_.file_path, cache.SerializeAsString()))
+    LOG(kWarning) << "Failed to write public key cache " << kOptions_.file_path;
+}
+
+PublicKeyCache::Metrics PublicKeyCache::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+void PublicKeyCache::Fetch(const NodeId& node_id) {
+  KeyRecord record;
+  bool fetched(false);
+  try {
+    record = kFetch_(node_id);
+    fetched = MatchesNodeId(node_id, record);
+    if (!fetched)
+      LOG(kWarning) << "Fetched public key does not match " << DebugId(node_id);
+  }
+  catch(const std::exception& e) {
+    LOG(kWarning) << "Failed to fetch public key of " << DebugId(node_id) << ": " << e.what();
+  }
+
+  std::vector<GiveKeyFunctor> waiters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiters.swap(in_flight_[node_id]);
+    in_flight_.erase(node_id);
+    if (fetched)
+      Insert(node_id, record, Now() + kOptions_.time_to_live.count());
+    else
+      ++metrics_.failures;
+  }
+
+  if (fetched) {
+    for (auto& give_key : waiters) {
+      try {
+        give_key(record.public_key);
+      }
+      catch(const std::exception& e) {
+        LOG(kError) << "Giving public key of " << DebugId(node_id) << " threw: " << e.what();
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  --running_fetches_;
+  fetches_done_.notify_all();
+}
+
+void PublicKeyCache::Insert(const NodeId& node_id, const KeyRecord& record, int64_t expiry) {
+  auto result(entries_.insert(std::make_pair(node_id, Entry())));
+  Entry& entry(result.first->second);
+  if (result.second) {
+    recency_.push_front(node_id);
+    entry.recency = recency_.begin();
+  } else {
+    recency_.splice(recency_.begin(), recency_, entry.recency);
+  }
+  entry.record = record;
+  entry.expiry = expiry;
+
+  while (entries_.size() > kOptions_.capacity) {
+    entries_.erase(recency_.back());
+    recency_.pop_back();
+    ++metrics_.evictions;
+  }
+}
+
+void PublicKeyCache::Load() {
+  if (kOptions_.file_path.empty())
+    return;
+  std::string content;
+  if (!ReadFile(kOptions_.file_path, &content) || content.empty())
+    return;
+  PublicKeyCacheData cache;
+  if (!cache.ParseFromString(content)) {
+    LOG(kWarning) << "Ignoring unparseable public key cache " << kOptions_.file_path;
+    return;
+  }
+  int64_t now(Now());
+  // The file is shared by all accounts on this machine and may have been tampered with, so only
+  // entries whose key matches their node id are used.  Entries are saved most recently used first,
+  // so inserting in reverse restores their order.
+  for (int i(cache.entries_size() - 1); i >= 0; --i) {
+    const PublicKeyCacheData::Entry& cache_entry(cache.entries(i));
+    if (cache_entry.expiry() <= now)
+      continue;
+    try {
+      NodeId node_id(cache_entry.node_id());
+      KeyRecord record;
+      record.public_key =
+          asymm::DecodeKey(asymm::EncodedPublicKey(NonEmptyString(cache_entry.public_key())));
+      record.validation_token = cache_entry.validation_token();
+      if (!MatchesNodeId(node_id, record)) {
+        LOG(kWarning) << "Ignoring public key cache entry for " << DebugId(node_id)
+                      << " whose key does not match.";
+        continue;
+      }
+      Insert(node_id, record, cache_entry.expiry());
+    }
+    catch(const std::exception& e) {
+      LOG(kWarning) << "Ignoring invalid public key cache entry: " << e.what();
+    }
+  }
+  metrics_.evictions = 0;
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
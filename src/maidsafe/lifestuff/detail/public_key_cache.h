@@ -0,0 +1,128 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_PUBLIC_KEY_CACHE_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_PUBLIC_KEY_CACHE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/lifestuff/detail/executor.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+struct PublicKeyCacheOptions {
+  PublicKeyCacheOptions() : capacity(1024), time_to_live(std::chrono::hours(1)), fetch_threads(2),
+                            file_path() {}
+  // Least recently used keys beyond this are evicted.
+  size_t capacity;
+  std::chrono::milliseconds time_to_live;
+  // Fetches block until the network answers, so they run on threads of their own rather than on
+  // the executor serving routing.
+  uint32_t fetch_threads;
+  // If not empty, the cache is loaded from here on construction and written by Save().
+  boost::filesystem::path file_path;
+};
+
+// Answers routing's requests for nodes' public keys from a bounded LRU cache, fetching a key on a
+// miss.  Concurrent requests for the same node share a single fetch.  Every key, whether fetched or
+// loaded from file, is checked against the node's id before use.
+class PublicKeyCache {
+ public:
+  typedef std::function<void(asymm::PublicKey)> GiveKeyFunctor;
+
+  // A node's public key and the token which, as for a passport::PublicPmid, proves the node's id:
+  // the id is the SHA512 hash of the encoded key followed by the token.
+  struct KeyRecord {
+    KeyRecord() : public_key(), validation_token() {}
+    asymm::PublicKey public_key;
+    std::string validation_token;
+  };
+  // Blocks until the key is retrieved; throws on failure.
+  typedef std::function<KeyRecord(const NodeId&)> FetchFunctor;
+
+  struct Metrics {
+    Metrics() : hits(0), misses(0), coalesced(0), failures(0), evictions(0) {}
+    uint64_t hits, misses;
+    // Misses which joined a fetch already in flight for the same node.
+    uint64_t coalesced;
+    uint64_t failures, evictions;
+  };
+
+  PublicKeyCache(FetchFunctor fetch, const PublicKeyCacheOptions& options);
+  ~PublicKeyCache();
+
+  // Calls 'give_key' immediately on a hit, otherwise on a fetch thread once the key has been
+  // fetched.  If the fetch fails, or the key does not match 'node_id', 'give_key' is not called and
+  // routing times the request out.
+  void Get(const NodeId& node_id, const GiveKeyFunctor& give_key);
+  void Remove(const NodeId& node_id);
+  // Writes the unexpired keys held here, most recently used first, followed by those in the file
+  // which other clients may have saved since this one loaded it, up to the capacity, and
+  // atomically replaces the file with the result.  Failures are logged but not thrown; the cache
+  // is only an optimisation.
+  void Save() const;
+  Metrics metrics() const;
+
+ private:
+  PublicKeyCache(const PublicKeyCache&);
+  PublicKeyCache& operator=(const PublicKeyCache&);
+
+  struct Entry {
+    Entry() : record(), expiry(0), recency() {}
+    KeyRecord record;
+    int64_t expiry;
+    std::list<NodeId>::iterator recency;
+  };
+
+  void Fetch(const NodeId& node_id);
+  void Insert(const NodeId& node_id, const KeyRecord& record, int64_t expiry);
+  void Load();
+
+  const FetchFunctor kFetch_;
+  const PublicKeyCacheOptions kOptions_;
+  std::map<NodeId, Entry> entries_;
+  // Most recently used first.
+  std::list<NodeId> recency_;
+  std::map<NodeId, std::vector<GiveKeyFunctor>> in_flight_;
+  uint32_t running_fetches_;
+  Metrics metrics_;
+  mutable std::mutex mutex_;
+  std::condition_variable fetches_done_;
+  // Declared last so that it is destroyed, running any queued fetches, before the state they use.
+  Executor fetch_executor_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_PUBLIC_KEY_CACHE_H_
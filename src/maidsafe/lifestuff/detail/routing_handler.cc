@@ -18,24 +18,41 @@
 
 #include "maidsafe/lifestuff/detail/routing_handler.h"
 
+#include "maidsafe/lifestuff/detail/trace.h"
+
 namespace maidsafe {
 namespace lifestuff {
 
-RoutingHandler::RoutingHandler(const Maid& maid, PublicKeyRequestFunction public_key_request)
-  : routing_(maid),
-    public_key_request_(public_key_request),
+RoutingHandler::RoutingHandler(const Maid& maid,
+                               Executor& executor,
+                               PublicKeyRequestFunction public_key_request)
+  : public_key_request_(public_key_request),
     network_health_(),
+    join_observers_(),
+    join_started_(),
+    joined_(false),
+    pending_tasks_(0),
+    stopping_(false),
     mutex_(),
     condition_variable_(),
-    asio_service_(2) {
-  asio_service_.Start();
-}
+    executor_(executor),
+    routing_(maid) {}
 
 RoutingHandler::~RoutingHandler() {
-  asio_service_.Stop();
+  // The executor may outlive this handler, so wait for any tasks already posted to it.
+  std::unique_lock<std::mutex> lock(mutex_);
+  stopping_ = true;
+  condition_variable_.wait(lock, [this] { return pending_tasks_ == 0; });
 }
 
-void RoutingHandler::Join(const EndPointVector& bootstrap_endpoints) {
+void RoutingHandler::Join(const EndPointVector& bootstrap_endpoints,
+                          const JoinObservers& join_observers) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    join_observers_ = join_observers;
+    join_started_ = std::chrono::steady_clock::now();
+    joined_ = false;
+  }
   routing_.Join(InitialiseFunctors(), UdpEndpoints(bootstrap_endpoints));
   return;
 }
@@ -64,17 +81,32 @@ RoutingHandler::Functors RoutingHandler::InitialiseFunctors() {
   return functors;
 }
 
-void RoutingHandler::OnMessageReceived(const std::string& message,
-                                       const ReplyFunctor& reply_functor) {
-  asio_service_.service().post([=] { DoOnMessageReceived(message, reply_functor); });
+template<typename Functor>
+void RoutingHandler::Post(const char* trace_name, Functor functor) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_)
+      return;
+    ++pending_tasks_;
+  }
+  executor_.Post([this, trace_name, functor] {
+                   {
+                     trace::Span span(trace_name);
+                     functor();
+                   }
+                   std::lock_guard<std::mutex> lock(mutex_);
+                   --pending_tasks_;
+                   condition_variable_.notify_all();
+                 });
 }
 
-void RoutingHandler::DoOnMessageReceived(const std::string& /*message*/,
-                                         const ReplyFunctor& /*reply_functor*/) {
+void RoutingHandler::OnMessageReceived(const std::string& /*message*/,
+                                       const ReplyFunctor& /*reply_functor*/) {
+  LOG(kVerbose) << "No handler for inbound messages; dropping message.";
 }
 
 void RoutingHandler::OnNetworkStatusChange(const int& network_health) {
-  asio_service_.service().post([=] { DoOnNetworkStatusChange(network_health); });
+  Post("RoutingHandler::DoOnNetworkStatusChange", [=] { DoOnNetworkStatusChange(network_health); });
 }
 
 void RoutingHandler::DoOnNetworkStatusChange(const int& network_health) {
@@ -92,11 +124,26 @@ void RoutingHandler::DoOnNetworkStatusChange(const int& network_health) {
                   << " - Network is down (" << network_health << ")";
   }
   network_health_ = network_health;
+
+  std::function<void(std::chrono::milliseconds)> joined;
+  std::chrono::milliseconds join_duration(0);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (network_health <= 0 || joined_)
+      return;
+    joined_ = true;
+    joined = join_observers_.joined;
+    join_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - join_started_);
+  }
+  if (joined)
+    joined(join_duration);
 }
 
 void RoutingHandler::OnPublicKeyRequested(const NodeId& node_id,
                                           const GivePublicKeyFunctor& give_key) {
-  asio_service_.service().post([=] { DoOnPublicKeyRequested(node_id, give_key); });
+  Post("RoutingHandler::DoOnPublicKeyRequested",
+       [=] { DoOnPublicKeyRequested(node_id, give_key); });
 }
 
 void RoutingHandler::DoOnPublicKeyRequested(const NodeId& node_id,
@@ -105,10 +152,17 @@ void RoutingHandler::DoOnPublicKeyRequested(const NodeId& node_id,
 }
 
 void RoutingHandler::OnNewBootstrapEndpoint(const UdpEndPoint& endpoint) {
-  asio_service_.service().post([=] { DoOnNewBootstrapEndpoint(endpoint); });
+  Post("RoutingHandler::DoOnNewBootstrapEndpoint", [=] { DoOnNewBootstrapEndpoint(endpoint); });
 }
 
-void RoutingHandler::DoOnNewBootstrapEndpoint(const UdpEndPoint& /*endpoint*/) {
+void RoutingHandler::DoOnNewBootstrapEndpoint(const UdpEndPoint& endpoint) {
+  std::function<void(const EndPoint&)> new_bootstrap_endpoint;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    new_bootstrap_endpoint = join_observers_.new_bootstrap_endpoint;
+  }
+  if (new_bootstrap_endpoint)
+    new_bootstrap_endpoint(std::make_pair(endpoint.address().to_string(), endpoint.port()));
 }
 
 RoutingHandler::UdpEndPointVector RoutingHandler::UdpEndpoints(const EndPointVector& endpoints) {
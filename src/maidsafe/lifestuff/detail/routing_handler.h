@@ -19,13 +19,17 @@
 #ifndef MAIDSAFE_LIFESTUFF_DETAIL_ROUTING_HANDLER_H_
 #define MAIDSAFE_LIFESTUFF_DETAIL_ROUTING_HANDLER_H_
 
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <condition_variable>
 
 #include "maidsafe/routing/routing_api.h"
 
+#include "maidsafe/lifestuff/detail/executor.h"
+
 namespace maidsafe {
 namespace lifestuff {
  
@@ -43,10 +47,23 @@ class RoutingHandler {
   typedef std::vector<UdpEndPoint> UdpEndPointVector;
   typedef passport::Maid Maid;
 
-  RoutingHandler(const Maid& maid, PublicKeyRequestFunction public_key_request);
+  // Optional notifications for a Join, invoked on the executor.  'joined' is called once, when the
+  // network health first becomes positive, with the time taken since Join was called.
+  struct JoinObservers {
+    std::function<void(const EndPoint&)> new_bootstrap_endpoint;
+    std::function<void(std::chrono::milliseconds)> joined;
+  };
+
+  // Callbacks from routing are handled on 'executor', which may be shared between several handlers
+  // and must outlive this one.  The client handles no unsolicited messages yet, so inbound
+  // messages are dropped on routing's thread rather than queued for the executor.
+  RoutingHandler(const Maid& maid,
+                 Executor& executor,
+                 PublicKeyRequestFunction public_key_request);
   ~RoutingHandler();
 
-  void Join(const EndPointVector& endpoints);
+  void Join(const EndPointVector& endpoints,
+            const JoinObservers& join_observers = JoinObservers());
 
   Routing& routing();
 
@@ -55,9 +72,9 @@ class RoutingHandler {
   RoutingHandler& operator=(const RoutingHandler&);
 
   Functors InitialiseFunctors();
+  template<typename Functor> void Post(const char* trace_name, Functor functor);
   
   void OnMessageReceived(const std::string& message,  const ReplyFunctor& reply_functor);
-  void DoOnMessageReceived(const std::string& message, const ReplyFunctor& reply_functor);
   void OnNetworkStatusChange(const int& network_health);
   void DoOnNetworkStatusChange(const int& network_health);
   void OnPublicKeyRequested(const NodeId &node_id, const GivePublicKeyFunctor &give_key);
@@ -67,12 +84,18 @@ class RoutingHandler {
 
   UdpEndPointVector UdpEndpoints(const EndPointVector& bootstrap_endpoints);
 
-  Routing routing_;
   PublicKeyRequestFunction public_key_request_;
   int network_health_;
+  JoinObservers join_observers_;
+  std::chrono::steady_clock::time_point join_started_;
+  bool joined_;
+  int pending_tasks_;
+  bool stopping_;
   std::mutex mutex_;
   std::condition_variable condition_variable_;
-  AsioService asio_service_;
+  Executor& executor_;
+  // Declared last so that it is destroyed first, while the members its callbacks use are valid.
+  Routing routing_;
 };
 
 }  // namespace lifestuff
@@ -32,11 +32,34 @@
 namespace maidsafe {
 namespace lifestuff {
 
+namespace {
+
+// Version 1 sessions hold their timestamp as a decimal string; later versions as an integer.
+const uint32_t kDataAtlasVersion(2);
+
+int64_t Timestamp(const DataAtlas& data_atlas) {
+  if (data_atlas.has_timestamp_us())
+    return data_atlas.timestamp_us();
+  if (data_atlas.has_timestamp())
+    return boost::lexical_cast<int64_t>(data_atlas.timestamp());
+  ThrowError(CommonErrors::parsing_error);
+  return 0;
+}
+
+}  // unnamed namespace
+
 Session::Session()
-    : passport_(),
+    : passport_(new Passport()),
+      passport_pending_(false),
+      passport_mutex_(),
       bootstrap_endpoints_(),
       user_details_(),
       initialised_(false),
+      timestamp_(0),
+      modified_fields_(kUserDetailsModified | kUsedSpaceModified | kPassportModified |
+                       kBootstrapEndpointsModified),
+      data_atlas_(new DataAtlas()),
+      serialised_session_(),
       keyword_(),
       pin_(),
       password_() {}
@@ -44,7 +67,25 @@ Session::Session()
 Session::~Session() {}
 
 Session::Passport& Session::passport() {
-  return passport_;
+  std::lock_guard<std::mutex> lock(passport_mutex_);
+  if (passport_pending_) {
+    passport_->Parse(NonEmptyString(data_atlas_->passport_data().serialised_keyring()));
+    passport_pending_ = false;
+  }
+  return *passport_;
+}
+
+void Session::set_passport(std::unique_ptr<Passport> passport) {
+  if (!passport)
+    ThrowError(CommonErrors::invalid_parameter);
+  std::lock_guard<std::mutex> lock(passport_mutex_);
+  passport_ = std::move(passport);
+  passport_pending_ = false;
+  modified_fields_ |= kPassportModified;
+}
+
+void Session::set_passport_modified() {
+  modified_fields_ |= kPassportModified;
 }
 
 NonEmptyString Session::session_name() const {
@@ -75,6 +116,14 @@ bool Session::initialised() {
   return initialised_;
 }
 
+int64_t Session::timestamp() const {
+  return timestamp_;
+}
+
+uint32_t Session::modified_fields() const {
+  return modified_fields_;
+}
+
 const Keyword& Session::keyword() const {
   return *keyword_;
 }
@@ -90,26 +139,42 @@ const Password& Session::password() const {
 void Session::set_session_name() {
   NonEmptyString random(RandomAlphaNumericString(64));
   user_details_.session_name = NonEmptyString(EncodeToHex(crypto::Hash<crypto::SHA1>(random)));
+  modified_fields_ |= kUserDetailsModified;
 }
 
 void Session::set_unique_user_id(const Identity& unique_user_id) {
+  if (user_details_.unique_user_id == unique_user_id)
+    return;
   user_details_.unique_user_id = unique_user_id;
+  modified_fields_ |= kUserDetailsModified;
 }
 
 void Session::set_drive_root_id(const std::string& drive_root_id) {
+  if (user_details_.drive_root_id == drive_root_id)
+    return;
   user_details_.drive_root_id = drive_root_id;
+  modified_fields_ |= kUserDetailsModified;
 }
 
 void Session::set_storage_path(const boost::filesystem::path& vault_path) {
+  if (user_details_.storage_path == vault_path)
+    return;
   user_details_.storage_path = vault_path;
+  modified_fields_ |= kUserDetailsModified;
 }
 
 void Session::set_max_space(const int64_t& max_space) {
+  if (user_details_.max_space == max_space)
+    return;
   user_details_.max_space = max_space;
+  modified_fields_ |= kUserDetailsModified;
 }
 
 void Session::set_used_space(const int64_t& used_space) {
+  if (user_details_.used_space == used_space)
+    return;
   user_details_.used_space = used_space;
+  modified_fields_ |= kUsedSpaceModified;
 }
 
 void Session::set_initialised() {
@@ -141,7 +206,10 @@ void Session::set_keyword_pin_password(const Keyword& keyword,
 }
 
 void Session::set_bootstrap_endpoints(const std::vector<Endpoint>& bootstrap_endpoints) {
+  if (bootstrap_endpoints_ == bootstrap_endpoints)
+    return;
   bootstrap_endpoints_ = bootstrap_endpoints;
+  modified_fields_ |= kBootstrapEndpointsModified;
 }
 
 std::vector<std::pair<std::string, uint16_t> > Session::bootstrap_endpoints() const {
@@ -156,36 +224,67 @@ void Session::Parse(const NonEmptyString& serialised_data_atlas) {
     LOG(kError) << "Unique user ID is empty.";
     return;
   }
+  if (data_atlas.version() > kDataAtlasVersion)
+    LOG(kWarning) << "Parsing session of newer version " << data_atlas.version();
 
   set_unique_user_id(Identity(data_atlas.user_data().unique_user_id()));
   set_drive_root_id(data_atlas.user_data().drive_root_id());
   set_storage_path(data_atlas.user_data().storage_path());
   set_max_space(data_atlas.user_data().max_space());
   set_used_space(data_atlas.user_data().used_space());
+  timestamp_ = Timestamp(data_atlas);
+
+  {
+    std::lock_guard<std::mutex> lock(passport_mutex_);
+    if (data_atlas.passport_data().serialised_keyring().empty())
+      ThrowError(CommonErrors::parsing_error);
+    // The parsed message is kept, so its keyring is decoded from and re-serialised in place.
+    data_atlas_->Swap(&data_atlas);
+    passport_.reset(new Passport());
+    passport_pending_ = true;
+  }
 
-  passport_.Parse(NonEmptyString(data_atlas.passport_data().serialised_keyring()));
-
+  serialised_session_.reset(new NonEmptyString(serialised_data_atlas));
+  modified_fields_ = 0;
   return;
 }
 
 NonEmptyString Session::Serialise() {
-  DataAtlas data_atlas;
+  if (modified_fields_ == 0 && serialised_session_)
+    return *serialised_session_;
 
-  UserData* user_data(data_atlas.mutable_user_data());
+  // The same message is reused for every save, so its sub-messages and strings keep their
+  // allocations, and an unmodified keyring is not copied at all.
+  data_atlas_->set_version(kDataAtlasVersion);
+  UserData* user_data(data_atlas_->mutable_user_data());
   user_data->set_unique_user_id(unique_user_id().string());
   user_data->set_drive_root_id(drive_root_id());
   user_data->set_storage_path(storage_path().string());
   user_data->set_max_space(max_space());
   user_data->set_used_space(used_space());
 
-  data_atlas.set_timestamp(boost::lexical_cast<std::string>(
-      GetDurationSinceEpoch().total_microseconds()));
+  timestamp_ = GetDurationSinceEpoch().total_microseconds();
+  data_atlas_->set_timestamp_us(timestamp_);
+  // Version 1 clients require the string timestamp, so it is kept until they are retired.
+  data_atlas_->set_timestamp(boost::lexical_cast<std::string>(timestamp_));
+
+  PassportData* passport_data(data_atlas_->mutable_passport_data());
+  if ((modified_fields_ & kPassportModified) || passport_data->serialised_keyring().empty())
+    passport_data->set_serialised_keyring(passport_->Serialise().string());
+
+  serialised_session_.reset(new NonEmptyString(data_atlas_->SerializeAsString()));
+  return *serialised_session_;
+}
 
-  NonEmptyString serialised_keyring(passport_.Serialise());
-  PassportData* passport_data(data_atlas.mutable_passport_data());
-  passport_data->set_serialised_keyring(serialised_keyring.string());
+void Session::MarkSaved() {
+  modified_fields_ = 0;
+}
 
-  return NonEmptyString(data_atlas.SerializeAsString());
+int64_t Session::ParseTimestamp(const NonEmptyString& serialised_data_atlas) {
+  DataAtlas data_atlas;
+  if (!data_atlas.ParseFromString(serialised_data_atlas.string()))
+    ThrowError(CommonErrors::parsing_error);
+  return Timestamp(data_atlas);
 }
 
 }  // namespace lifestuff
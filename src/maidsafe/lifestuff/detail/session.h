@@ -21,6 +21,7 @@
 
 #include <mutex>
 #include <map>
+#include <memory>
 #include <string>
 #include <set>
 #include <utility>
@@ -38,6 +39,8 @@ namespace lifestuff {
 
 namespace test { class SessionTest; }
 
+class DataAtlas;
+
 typedef passport::detail::Keyword Keyword;
 typedef passport::detail::Pin Pin;
 typedef passport::detail::Password Password;
@@ -46,11 +49,24 @@ class Session {
  public:
   typedef passport::Passport Passport;
   typedef std::pair<std::string, uint16_t> Endpoint;
+  // Bits of modified_fields() identifying what has changed since the session was last saved (see
+  // MarkSaved) or parsed.
+  enum ModifiedField {
+    kUserDetailsModified = 0x1,
+    kUsedSpaceModified = 0x2,
+    kPassportModified = 0x4,
+    kBootstrapEndpointsModified = 0x8
+  };
 
   Session();
   ~Session();
 
+  // The keyring of a parsed session is only decoded on first access.
   Passport& passport();
+  // Replaces the current passport, e.g. with one taken from a FobPool.
+  void set_passport(std::unique_ptr<Passport> passport);
+  // Changes made through passport() are not tracked, so must be reported via this.
+  void set_passport_modified();
 
   NonEmptyString session_name() const;
   Identity unique_user_id() const;
@@ -62,6 +78,10 @@ class Session {
   const Keyword& keyword() const;
   const Pin& pin() const;
   const Password& password() const;
+  // Microseconds since epoch at which the session was last serialised or, if parsed since, at
+  // which the parsed copy was serialised.
+  int64_t timestamp() const;
+  uint32_t modified_fields() const;
 
   void set_session_name();
   void set_unique_user_id(const Identity& unique_user_id);
@@ -79,7 +99,14 @@ class Session {
   std::vector<Endpoint> bootstrap_endpoints() const;
 
   void Parse(const NonEmptyString& serialised_session);
+  // Returns the previous result unchanged (including its timestamp) if nothing has been modified
+  // since the last save.  Otherwise only the passport's keyring is reused unless it too has been
+  // modified.  modified_fields() is left unchanged, as the result may yet fail to be stored.
   NonEmptyString Serialise();
+  // Clears modified_fields() once the result of the last Serialise() has been stored.
+  void MarkSaved();
+  // Reads only the timestamp of a serialised session, e.g. to decide which of two copies is newer.
+  static int64_t ParseTimestamp(const NonEmptyString& serialised_session);
 
   friend class test::SessionTest;
 
@@ -103,15 +130,21 @@ class Session {
     NonEmptyString session_name;
   };
 
-  Passport passport_;
+  std::unique_ptr<Passport> passport_;
+  // True while passport_ is empty and the keyring is held only in data_atlas_.
+  bool passport_pending_;
+  std::mutex passport_mutex_;
   std::vector<Endpoint> bootstrap_endpoints_;
   UserDetails user_details_;
   bool initialised_;
+  int64_t timestamp_;
+  uint32_t modified_fields_;
+  // The most recently parsed or serialised session, holding the serialised keyring.
+  std::unique_ptr<DataAtlas> data_atlas_;
+  std::unique_ptr<NonEmptyString> serialised_session_;
   std::unique_ptr<Keyword> keyword_;
   std::unique_ptr<Pin> pin_;
   std::unique_ptr<Password> password_;
-
-  // probably need a modified bool here since used_space varies.
 };
 
 }  // namespace lifestuff
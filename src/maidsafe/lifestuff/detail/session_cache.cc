@@ -0,0 +1,97 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/session_cache.h"
+
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/file_utils.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+SessionCache::SessionCache(const boost::filesystem::path& directory)
+  : kDirectory_(directory),
+    mutex_() {}
+
+bool SessionCache::Get(const Mid::Name& mid_name, EncryptedSession& encrypted_session) const {
+  std::string content;
+  if (!Read(FilePath(mid_name), content))
+    return false;
+  encrypted_session = EncryptedSession(NonEmptyString(content));
+  return true;
+}
+
+void SessionCache::Put(const Mid::Name& mid_name, const EncryptedSession& encrypted_session) {
+  Write(FilePath(mid_name), encrypted_session.data.string());
+}
+
+void SessionCache::Delete(const Mid::Name& mid_name) {
+  boost::filesystem::path file_path(FilePath(mid_name));
+  std::lock_guard<std::mutex> lock(mutex_);
+  boost::system::error_code error_code;
+  boost::filesystem::remove(file_path, error_code);
+  boost::filesystem::remove(file_path.string() + ".tmid", error_code);
+}
+
+bool SessionCache::GetTmidName(const Mid::Name& mid_name,
+                               EncryptedTmidName& encrypted_tmid_name) const {
+  std::string content;
+  if (!Read(FilePath(mid_name).string() + ".tmid", content))
+    return false;
+  encrypted_tmid_name = EncryptedTmidName(NonEmptyString(content));
+  return true;
+}
+
+void SessionCache::PutTmidName(const Mid::Name& mid_name,
+                               const EncryptedTmidName& encrypted_tmid_name) {
+  Write(FilePath(mid_name).string() + ".tmid", encrypted_tmid_name.data.string());
+}
+
+boost::filesystem::path SessionCache::FilePath(const Mid::Name& mid_name) const {
+  return kDirectory_ / EncodeToHex(crypto::Hash<crypto::SHA1>(mid_name.data));
+}
+
+bool SessionCache::Read(const boost::filesystem::path& file_path, std::string& content) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ReadFile(file_path, &content) && !content.empty();
+}
+
+void SessionCache::Write(const boost::filesystem::path& file_path, const std::string& content) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  boost::system::error_code error_code;
+  if (!boost::filesystem::exists(kDirectory_, error_code)) {
+    boost::filesystem::create_directories(kDirectory_, error_code);
+    if (error_code) {
+      LOG(kWarning) << "Failed to create session cache dir(" << kDirectory_ << "): "
+                    << error_code.message();
+      return;
+    }
+  }
+  if (!ReplaceFile(file_path, content))
+    LOG(kWarning) << "Failed to write " << file_path.filename() << " to session cache.";
+}
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,70 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_SESSION_CACHE_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_SESSION_CACHE_H_
+
+#include <mutex>
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/passport/passport.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+// Stores the encrypted session of each account logged in on this machine, keyed by a hash of its
+// MID name.  Entries are only ever written in the form already stored on the network, i.e.
+// encrypted with the keyword/pin/password derived key.
+class SessionCache {
+ public:
+  typedef passport::Mid Mid;
+  typedef passport::EncryptedSession EncryptedSession;
+  typedef passport::EncryptedTmidName EncryptedTmidName;
+
+  explicit SessionCache(const boost::filesystem::path& directory);
+
+  // Returns false if there is no (readable) entry for 'mid_name'.
+  bool Get(const Mid::Name& mid_name, EncryptedSession& encrypted_session) const;
+  // Failures are logged but not thrown; the cache is only an optimisation.  Entries are replaced
+  // atomically, so a crash while writing one leaves the previous entry in place.
+  void Put(const Mid::Name& mid_name, const EncryptedSession& encrypted_session);
+  void Delete(const Mid::Name& mid_name);
+
+  // The encrypted TMID name last seen in the account's MID, used to start fetching the TMID
+  // before the MID itself has been retrieved.
+  bool GetTmidName(const Mid::Name& mid_name, EncryptedTmidName& encrypted_tmid_name) const;
+  void PutTmidName(const Mid::Name& mid_name, const EncryptedTmidName& encrypted_tmid_name);
+
+ private:
+  SessionCache(const SessionCache&);
+  SessionCache& operator=(const SessionCache&);
+
+  boost::filesystem::path FilePath(const Mid::Name& mid_name) const;
+  bool Read(const boost::filesystem::path& file_path, std::string& content) const;
+  void Write(const boost::filesystem::path& file_path, const std::string& content);
+
+  const boost::filesystem::path kDirectory_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_SESSION_CACHE_H_
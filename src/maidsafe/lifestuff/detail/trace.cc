@@ -0,0 +1,186 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/lifestuff/detail/trace.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace trace {
+
+namespace {
+
+const uint64_t kEventsPerThread(4096);
+
+// A slot holding the event with index i has sequence 2i + 2 once written and 2i + 1 while its
+// owning thread is writing it, so a reader can skip both torn events and events which have been
+// overwritten by a later lap of the ring.
+struct Slot {
+  Slot() : sequence(0), name(nullptr), thread_id(0), start(0), duration(0) {}
+  std::atomic<uint64_t> sequence;
+  std::atomic<const char*> name;
+  std::atomic<uint32_t> thread_id;
+  std::atomic<int64_t> start, duration;
+};
+
+struct ThreadBuffer {
+  ThreadBuffer() : next(0), slots(kEventsPerThread) {}
+  std::atomic<uint64_t> next;
+  std::vector<Slot> slots;
+};
+
+struct Event {
+  const char* name;
+  uint32_t thread_id;
+  int64_t start, duration;
+};
+
+std::atomic<bool> g_enabled(false);
+std::mutex g_buffers_mutex;
+// Every buffer ever created.  A thread's buffer is returned to g_free_buffers when it exits and
+// handed to the next thread which starts tracing, so the number of buffers is bounded by the peak
+// number of concurrently tracing threads.  Until then its events can still be exported.
+std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+std::vector<ThreadBuffer*> g_free_buffers;
+uint32_t g_next_thread_id(1);
+
+int64_t Now() {
+  static const std::chrono::steady_clock::time_point kEpoch(std::chrono::steady_clock::now());
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - kEpoch).count();
+}
+
+// Holds the calling thread's buffer and recycles it when the thread exits.
+class BufferOwner {
+ public:
+  BufferOwner() : buffer_(nullptr), thread_id_(0) {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    thread_id_ = g_next_thread_id++;
+    if (g_free_buffers.empty()) {
+      g_buffers.push_back(std::make_shared<ThreadBuffer>());
+      buffer_ = g_buffers.back().get();
+    } else {
+      buffer_ = g_free_buffers.back();
+      g_free_buffers.pop_back();
+    }
+  }
+
+  ~BufferOwner() {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    g_free_buffers.push_back(buffer_);
+  }
+
+  ThreadBuffer& buffer() { return *buffer_; }
+  uint32_t thread_id() const { return thread_id_; }
+
+ private:
+  BufferOwner(const BufferOwner&);
+  BufferOwner& operator=(const BufferOwner&);
+
+  ThreadBuffer* buffer_;
+  uint32_t thread_id_;
+};
+
+void Append(const char* name, int64_t start, int64_t duration) {
+  thread_local BufferOwner owner;
+  ThreadBuffer& buffer(owner.buffer());
+  uint64_t index(buffer.next.load(std::memory_order_relaxed));
+  Slot& slot(buffer.slots[index % kEventsPerThread]);
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.thread_id.store(owner.thread_id(), std::memory_order_relaxed);
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.duration.store(duration, std::memory_order_relaxed);
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  buffer.next.store(index + 1, std::memory_order_release);
+}
+
+std::vector<Event> Snapshot() {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    buffers = g_buffers;
+  }
+  std::vector<Event> events;
+  for (auto& buffer : buffers) {
+    uint64_t end(buffer->next.load(std::memory_order_acquire));
+    uint64_t begin(end > kEventsPerThread ? end - kEventsPerThread : 0);
+    for (uint64_t index(begin); index != end; ++index) {
+      Slot& slot(buffer->slots[index % kEventsPerThread]);
+      const uint64_t kWritten(2 * index + 2);
+      if (slot.sequence.load(std::memory_order_acquire) != kWritten)
+        continue;
+      Event event = { slot.name.load(std::memory_order_relaxed),
+                      slot.thread_id.load(std::memory_order_relaxed),
+                      slot.start.load(std::memory_order_relaxed),
+                      slot.duration.load(std::memory_order_relaxed) };
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != kWritten || !event.name)
+        continue;
+      events.push_back(event);
+    }
+  }
+  return events;
+}
+
+}  // unnamed namespace
+
+Span::Span(const char* name) : name_(Enabled() ? name : nullptr), start_(name_ ? Now() : 0) {}
+
+Span::~Span() {
+  if (name_)
+    Append(name_, start_, Now() - start_);
+}
+
+void Enable(bool enable) {
+  g_enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool Enabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+void WriteChromeTrace(const boost::filesystem::path& file_path) {
+  std::ostringstream json;
+  json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first(true);
+  for (auto& event : Snapshot()) {
+    json << (first ? "" : ",") << "\n{\"name\":\"" << event.name
+         << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_id << ",\"ts\":" << event.start
+         << ",\"dur\":" << event.duration << '}';
+    first = false;
+  }
+  json << "\n]}\n";
+  if (!WriteFile(file_path, json.str()))
+    ThrowError(CommonErrors::filesystem_io_error);
+}
+
+}  // namespace trace
+
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,67 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_LIFESTUFF_DETAIL_TRACE_H_
+#define MAIDSAFE_LIFESTUFF_DETAIL_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+namespace lifestuff {
+
+namespace trace {
+
+// Records the wall-clock interval between construction and destruction as a complete event.
+// 'name' must be a string literal (or otherwise outlive the process's trace buffers).  Each thread
+// writes to its own fixed-size ring buffer without locking; the oldest events are overwritten, and
+// a thread's buffer is reused by a later thread once it exits.
+class Span {
+ public:
+  explicit Span(const char* name);
+  ~Span();
+
+ private:
+  Span(const Span&);
+  Span& operator=(const Span&);
+
+  const char* name_;
+  int64_t start_;
+};
+
+// Tracing is disabled by default, in which case spans cost only a relaxed atomic load.
+void Enable(bool enable);
+bool Enabled();
+
+// Writes all buffered events as Chrome trace event JSON, loadable by chrome://tracing or
+// https://ui.perfetto.dev.  Throws CommonErrors::filesystem_io_error on failure.
+void WriteChromeTrace(const boost::filesystem::path& file_path);
+
+}  // namespace trace
+
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+#define LIFESTUFF_TRACE_CONCAT_IMPL(a, b) a##b
+#define LIFESTUFF_TRACE_CONCAT(a, b) LIFESTUFF_TRACE_CONCAT_IMPL(a, b)
+#define LIFESTUFF_TRACE_SPAN(name) \
+    maidsafe::lifestuff::trace::Span LIFESTUFF_TRACE_CONCAT(trace_span_, __LINE__)(name)
+
+#endif  // MAIDSAFE_LIFESTUFF_DETAIL_TRACE_H_
@@ -22,6 +22,8 @@
 
 #include "maidsafe/common/utils.h"
 
+#include "maidsafe/lifestuff/detail/trace.h"
+
 
 namespace maidsafe {
 namespace lifestuff {
@@ -33,6 +35,7 @@ UserStorage::UserStorage()
       mount_thread_() {}
 
 void UserStorage::MountDrive(Storage& storage, Session& session) {
+  LIFESTUFF_TRACE_SPAN("UserStorage::MountDrive");
   if (mount_status_)
     return;
 #ifdef WIN32
@@ -65,6 +68,7 @@ void UserStorage::MountDrive(Storage& storage, Session& session) {
                              session.max_space(),
                              session.used_space()));
   mount_thread_ = std::move(std::thread([this] {
+                                          LIFESTUFF_TRACE_SPAN("UserStorage mount thread");
                                           drive_->Mount();
                                         }));
   mount_status_ = drive_->WaitUntilMounted();
@@ -72,6 +76,7 @@ void UserStorage::MountDrive(Storage& storage, Session& session) {
 }
 
 void UserStorage::UnMountDrive(Session& session) {
+  LIFESTUFF_TRACE_SPAN("UserStorage::UnMountDrive");
   if (!mount_status_)
     return;
   drive_->Unmount();
@@ -19,7 +19,12 @@
 #ifndef MAIDSAFE_LIFESTUFF_DETAIL_UTILS_H_
 #define MAIDSAFE_LIFESTUFF_DETAIL_UTILS_H_
 
+#include <future>
+
+#include "maidsafe/common/log.h"
+
 #include "maidsafe/passport/passport.h"
+#include "maidsafe/lifestuff/detail/input_policy.h"
 #include "maidsafe/lifestuff/detail/session.h"
 
 namespace maidsafe {
@@ -32,22 +37,116 @@ struct Paid;
 
 namespace detail {
 
+  // Blocks until 'future', if valid, is ready.  Any stored exception is discarded; used to drain
+  // concurrently running steps of an operation before rolling it back.
+  template <typename T>
+  void WaitQuietly(std::future<T>& future) {
+    if (!future.valid())
+      return;
+    try {
+      future.get();
+    }
+    catch(const std::exception& e) {
+      LOG(kWarning) << "Concurrent step failed during rollback: " << e.what();
+    }
+  }
+
+  template <typename... Fobs>
+  struct FobList {};
+
+  // The public counterpart of a private fob, which is what gets stored on the network.
+  template <typename Fob>
+  struct PublicFob;
+
+  template <>
+  struct PublicFob<passport::Anmaid> {
+    typedef passport::PublicAnmaid type;
+    static const char* name() { return "Anmaid"; }
+  };
+
+  template <>
+  struct PublicFob<passport::Maid> {
+    typedef passport::PublicMaid type;
+    static const char* name() { return "Maid"; }
+  };
+
+  template <>
+  struct PublicFob<passport::Pmid> {
+    typedef passport::PublicPmid type;
+    static const char* name() { return "Pmid"; }
+  };
+
+  template <>
+  struct PublicFob<passport::Anmid> {
+    typedef passport::PublicAnmid type;
+    static const char* name() { return "Anmid"; }
+  };
+
+  template <>
+  struct PublicFob<passport::Ansmid> {
+    typedef passport::PublicAnsmid type;
+    static const char* name() { return "Ansmid"; }
+  };
+
+  template <>
+  struct PublicFob<passport::Antmid> {
+    typedef passport::PublicAntmid type;
+    static const char* name() { return "Antmid"; }
+  };
+
+  // The fobs whose public parts are stored when an account is created: the free ones before the
+  // vault is registered, from the unconfirmed passport, and the paid ones after confirmation.
   template <typename Duty>
-  struct PutFobs {
-    typedef maidsafe::nfs::ClientMaidNfs ClientNfs;
-    typedef passport::Passport Passport;
+  struct PublishedFobs;
+
+  template <>
+  struct PublishedFobs<Free> {
+    typedef FobList<passport::Anmaid, passport::Maid, passport::Pmid> type;
+    static const bool kConfirmed = false;
+  };
+
+  template <>
+  struct PublishedFobs<Paid> {
+    typedef FobList<passport::Anmid, passport::Ansmid, passport::Antmid> type;
+    static const bool kConfirmed = true;
+  };
+
+  // Calls visitor.template Visit<Fob>() for each Fob in the list, in order.
+  template <typename List>
+  struct ForEachFob;
 
-    void operator()(ClientNfs&, Passport&/*, ReplyFunction&*/) {}
+  template <>
+  struct ForEachFob<FobList<>> {
+    template <typename Visitor>
+    static void Apply(Visitor&) {}
+  };
+
+  template <typename Fob, typename... Fobs>
+  struct ForEachFob<FobList<Fob, Fobs...>> {
+    template <typename Visitor>
+    static void Apply(Visitor& visitor) {
+      visitor.template Visit<Fob>();
+      ForEachFob<FobList<Fobs...>>::Apply(visitor);
+    }
   };
 
+  // In the following, 'size' tracks the number of characters held by 'input', which the input
+  // types themselves do not expose.  It is only meaningful while 'input' is set.
   template <typename Input>
   struct InsertUserInput {
     typedef std::unique_ptr<Input> InputPtr;
 
-    void operator()(InputPtr& input, uint32_t position, const std::string& characters) {
+    void operator()(InputPtr& input,
+                    uint32_t& size,
+                    uint32_t position,
+                    const std::string& characters) {
+      uint32_t current_size(input ? size : 0);
+      if (!IsValidInsertion<Input>(current_size, position, characters))
+        ThrowError(CommonErrors::invalid_parameter);
       if (!input)
         input.reset(new Input());
       input->Insert(position, characters);
+      size = current_size + static_cast<uint32_t>(characters.size());
       return;
     }
   };
@@ -56,10 +155,13 @@ namespace detail {
   struct RemoveUserInput {
     typedef std::unique_ptr<Input> InputPtr;
 
-    void operator()(InputPtr& input, uint32_t position, uint32_t length) {
+    void operator()(InputPtr& input, uint32_t& size, uint32_t position, uint32_t length) {
       if (!input)
         ThrowError(CommonErrors::uninitialised);
+      if (!IsValidRemoval(size, position, length))
+        ThrowError(CommonErrors::invalid_parameter);
       input->Remove(position, length);
+      size -= length;
       return;
     }
   };
@@ -68,9 +170,10 @@ namespace detail {
   struct ClearUserInput {
     typedef std::unique_ptr<Input> InputPtr;
 
-    void operator()(InputPtr& input) {
+    void operator()(InputPtr& input, uint32_t& size) {
       if (input)
         input->Clear();
+      size = 0;
       return;
     }
   };
@@ -82,7 +185,7 @@ namespace detail {
      bool operator()(InputPtr& input) {
       if (!input)
         return false;
-      return input->IsValid(boost::regex(kCharRegex));
+      return input->IsValid(ConfirmationRegex<Input>());
     }
 
     bool operator()(InputPtr& input, InputPtr& confirmation_input) {
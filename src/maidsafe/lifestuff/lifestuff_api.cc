@@ -19,6 +19,7 @@
 #include "maidsafe/lifestuff/lifestuff_api.h"
 
 #include "maidsafe/lifestuff/client_impl.h"
+#include "maidsafe/lifestuff/detail/trace.h"
 
 namespace maidsafe {
 namespace lifestuff {
@@ -31,8 +32,8 @@ struct ClientData {
   ClientMpid client_mpid_;
 };
 
-LifeStuff::LifeStuff(const Slots& slots)
-  : client_impl_(new ClientImpl<ClientData>(slots)) {}
+LifeStuff::LifeStuff(const Slots& slots, const ClientOptions& options)
+  : client_impl_(new ClientImpl<ClientData>(slots, options)) {}
 
 LifeStuff::~LifeStuff() {}
 
@@ -52,6 +53,24 @@ bool LifeStuff::ConfirmUserInput(InputField input_field) {
   return client_impl_->ConfirmUserInput(input_field);
 }
 
+void LifeStuff::ApplyUserInput(const std::vector<UserInputEdit>& edits) {
+  return client_impl_->ApplyUserInput(edits);
+}
+
+void LifeStuff::SetCredentials(const std::string& keyword,
+                               const std::string& pin,
+                               const std::string& password) {
+  return client_impl_->SetCredentials(keyword, pin, password);
+}
+
+std::map<InputField, bool> LifeStuff::ConfirmAllUserInput() {
+  return client_impl_->ConfirmAllUserInput();
+}
+
+void LifeStuff::PrepareCreateUser() {
+  return client_impl_->PrepareCreateUser();
+}
+
 void LifeStuff::CreateUser(const std::string& storage_path, ReportProgressFunction& report_progress) {
   return client_impl_->CreateUser(storage_path, report_progress);
 }
@@ -60,6 +79,14 @@ void LifeStuff::LogIn(const std::string& storage_path, ReportProgressFunction& r
   return client_impl_->LogIn(storage_path, report_progress);
 }
 
+void LifeStuff::UseLoopbackNetwork(const LoopbackNetworkOptions& options) {
+  return client_impl_->UseLoopbackNetwork(options);
+}
+
+void LifeStuff::EnableSessionCache(bool enable) {
+  return client_impl_->EnableSessionCache(enable);
+}
+
 void LifeStuff::LogOut() {
   return client_impl_->LogOut();
 }
@@ -84,10 +111,68 @@ void LifeStuff::ChangePassword(ReportProgressFunction& report_progress) {
   return client_impl_->ChangePassword(report_progress);
 }
 
+std::future<void> LifeStuff::CreateUserAsync(const std::string& storage_path,
+                                             const ReportProgressFunction& report_progress) {
+  return client_impl_->CreateUserAsync(storage_path, report_progress);
+}
+
+std::future<void> LifeStuff::LogInAsync(const std::string& storage_path,
+                                        const ReportProgressFunction& report_progress) {
+  return client_impl_->LogInAsync(storage_path, report_progress);
+}
+
+std::future<void> LifeStuff::LogOutAsync() {
+  return client_impl_->LogOutAsync();
+}
+
+std::future<void> LifeStuff::MountDriveAsync() {
+  return client_impl_->MountDriveAsync();
+}
+
+std::future<void> LifeStuff::UnMountDriveAsync() {
+  return client_impl_->UnMountDriveAsync();
+}
+
+std::future<void> LifeStuff::ChangeKeywordAsync(const ReportProgressFunction& report_progress) {
+  return client_impl_->ChangeKeywordAsync(report_progress);
+}
+
+std::future<void> LifeStuff::ChangePinAsync(const ReportProgressFunction& report_progress) {
+  return client_impl_->ChangePinAsync(report_progress);
+}
+
+std::future<void> LifeStuff::ChangePasswordAsync(const ReportProgressFunction& report_progress) {
+  return client_impl_->ChangePasswordAsync(report_progress);
+}
+
 bool LifeStuff::logged_in() const {
   return client_impl_->logged_in();
 }
 
+std::vector<PhaseStatistics> LifeStuff::GetPhaseStatistics() const {
+  return client_impl_->GetPhaseStatistics();
+}
+
+ExecutorStatistics LifeStuff::GetExecutorStatistics() const {
+  return client_impl_->GetExecutorStatistics();
+}
+
+FobPoolStatistics LifeStuff::GetFobPoolStatistics() const {
+  return client_impl_->GetFobPoolStatistics();
+}
+
+void LifeStuff::WritePhaseStatistics(const std::string& file_path) const {
+  return client_impl_->WritePhaseStatistics(file_path);
+}
+
+void LifeStuff::EnableTracing(bool enable) {
+  trace::Enable(enable);
+}
+
+void LifeStuff::WriteTrace(const std::string& file_path) {
+  trace::WriteChromeTrace(file_path);
+}
+
 std::string LifeStuff::mount_path() {
   return client_impl_->mount_path().string();
 }
@@ -16,6 +16,9 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <string>
+#include <vector>
+
 #include "boost/filesystem/path.hpp"
 #ifdef __MSVC__
 #  pragma warning(push)
@@ -74,7 +77,38 @@ class LifeStuffPython {
   bool ConfirmUserInput(ls::InputField input_field) {
     return lifestuff_.ConfirmUserInput(input_field);
   }
+  // 'edits' is a list of (input_field, operation, position, value) tuples, where 'value' is the
+  // characters to insert for kInsertInput, the number to remove for kRemoveInput, and ignored for
+  // kClearInput.
+  void ApplyUserInput(const bpy::list& edits) {
+    std::vector<ls::UserInputEdit> user_input_edits;
+    for (bpy::ssize_t i(0); i != bpy::len(edits); ++i) {
+      bpy::tuple edit_tuple(bpy::extract<bpy::tuple>(edits[i]));
+      ls::UserInputEdit edit;
+      edit.input_field = bpy::extract<ls::InputField>(edit_tuple[0]);
+      edit.operation = bpy::extract<ls::InputOperation>(edit_tuple[1]);
+      edit.position = bpy::extract<uint32_t>(edit_tuple[2]);
+      if (edit.operation == ls::kInsertInput)
+        edit.characters = bpy::extract<std::string>(edit_tuple[3]);
+      else if (edit.operation == ls::kRemoveInput)
+        edit.length = bpy::extract<uint32_t>(edit_tuple[3]);
+      user_input_edits.push_back(edit);
+    }
+    lifestuff_.ApplyUserInput(user_input_edits);
+  }
+  void SetCredentials(const std::string& keyword,
+                      const std::string& pin,
+                      const std::string& password) {
+    lifestuff_.SetCredentials(keyword, pin, password);
+  }
+  bpy::dict ConfirmAllUserInput() {
+    bpy::dict results;
+    for (auto& result : lifestuff_.ConfirmAllUserInput())
+      results[result.first] = result.second;
+    return results;
+  }
 
+  void PrepareCreateUser() { lifestuff_.PrepareCreateUser(); }
   void CreateUser(const std::string& vault_path, PyObject *py_callback) {
     ls::ReportProgressFunction cb([this, py_callback](ls::Action action,
                                                       ls::ProgressCode progresscode) {
@@ -197,6 +231,19 @@ BOOST_PYTHON_MODULE(lifestuff_python_api) {
                                       &SlotsExtractor::construct,
                                       bpy::type_id<maidsafe::lifestuff::Slots>());
 
+  bpy::enum_<ls::InputField>("InputField")
+      .value("kPin", ls::kPin)
+      .value("kKeyword", ls::kKeyword)
+      .value("kPassword", ls::kPassword)
+      .value("kConfirmationPin", ls::kConfirmationPin)
+      .value("kConfirmationKeyword", ls::kConfirmationKeyword)
+      .value("kConfirmationPassword", ls::kConfirmationPassword)
+      .value("kCurrentPassword", ls::kCurrentPassword);
+  bpy::enum_<ls::InputOperation>("InputOperation")
+      .value("kInsertInput", ls::kInsertInput)
+      .value("kRemoveInput", ls::kRemoveInput)
+      .value("kClearInput", ls::kClearInput);
+
   bpy::class_<LifeStuffPython, boost::noncopyable>(
       "LifeStuff", bpy::init<ls::Slots>())
 
@@ -205,11 +252,15 @@ BOOST_PYTHON_MODULE(lifestuff_python_api) {
       .def("RemoveUserInput", &LifeStuffPython::RemoveUserInput)
       .def("ClearUserInput", &LifeStuffPython::ClearUserInput)
       .def("ConfirmUserInput", &LifeStuffPython::ConfirmUserInput)
+      .def("ApplyUserInput", &LifeStuffPython::ApplyUserInput)
+      .def("SetCredentials", &LifeStuffPython::SetCredentials)
+      .def("ConfirmAllUserInput", &LifeStuffPython::ConfirmAllUserInput)
       .def("ChangeKeyword", &LifeStuffPython::ChangeKeyword)
       .def("ChangePin", &LifeStuffPython::ChangePin)
       .def("ChangePassword", &LifeStuffPython::ChangePassword)
 
       // User Behaviour
+      .def("PrepareCreateUser", &LifeStuffPython::PrepareCreateUser)
       .def("CreateUser", &LifeStuffPython::CreateUser)
       .def("LogIn", &LifeStuffPython::LogIn)
       .def("LogOut", &LifeStuffPython::LogOut)
@@ -0,0 +1,173 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/bootstrap_cache.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+typedef BootstrapCache::EndPoint EndPoint;
+typedef BootstrapCache::EndPointVector EndPointVector;
+
+EndPoint MakeEndPoint(uint16_t port) {
+  return std::make_pair(std::string("192.168.0.1"), port);
+}
+
+// Ensures that the next call to Seen records a later time than the previous one.
+void Tick() {
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+}  // unnamed namespace
+
+TEST(BootstrapCacheTest, BEH_RankedByRttThenRecency) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  BootstrapCache cache(*test_dir / "bootstrap_cache");
+  EXPECT_TRUE(cache.Ranked().empty());
+  for (uint16_t port(1); port != 5; ++port) {
+    cache.Seen(MakeEndPoint(port));
+    Tick();
+  }
+  cache.RecordRtt(MakeEndPoint(1), std::chrono::milliseconds(50));
+  cache.RecordRtt(MakeEndPoint(3), std::chrono::milliseconds(10));
+  EndPointVector expected;
+  expected.push_back(MakeEndPoint(3));
+  expected.push_back(MakeEndPoint(1));
+  expected.push_back(MakeEndPoint(4));
+  expected.push_back(MakeEndPoint(2));
+  EXPECT_EQ(expected, cache.Ranked());
+
+  // The RTT is smoothed, so a single slow sample does not demote the fastest endpoint.
+  cache.RecordRtt(MakeEndPoint(3), std::chrono::milliseconds(100));
+  EXPECT_EQ(MakeEndPoint(3), cache.Ranked().front());
+}
+
+TEST(BootstrapCacheTest, BEH_EndpointNeverSeenIsOmitted) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  BootstrapCache cache(*test_dir / "bootstrap_cache");
+  cache.RecordRtt(MakeEndPoint(1), std::chrono::milliseconds(10));
+  EXPECT_TRUE(cache.Ranked().empty());
+  cache.Seen(MakeEndPoint(1));
+  EXPECT_EQ(EndPointVector(1, MakeEndPoint(1)), cache.Ranked());
+}
+
+TEST(BootstrapCacheTest, BEH_MergeAndInterleave) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  BootstrapCache cache(*test_dir / "bootstrap_cache");
+  cache.Seen(MakeEndPoint(1));
+  cache.Seen(MakeEndPoint(2));
+  cache.RecordRtt(MakeEndPoint(1), std::chrono::milliseconds(10));
+  cache.RecordRtt(MakeEndPoint(2), std::chrono::milliseconds(20));
+  EndPointVector given;
+  given.push_back(MakeEndPoint(2));
+  given.push_back(MakeEndPoint(3));
+  given.push_back(MakeEndPoint(4));
+
+  EndPointVector expected;
+  expected.push_back(MakeEndPoint(1));
+  expected.push_back(MakeEndPoint(2));
+  expected.push_back(MakeEndPoint(3));
+  expected.push_back(MakeEndPoint(4));
+  EXPECT_EQ(expected, cache.Merge(given));
+
+  expected.clear();
+  expected.push_back(MakeEndPoint(1));
+  expected.push_back(MakeEndPoint(3));
+  expected.push_back(MakeEndPoint(2));
+  expected.push_back(MakeEndPoint(4));
+  EXPECT_EQ(expected, cache.Interleave(given));
+}
+
+TEST(BootstrapCacheTest, BEH_SaveAndLoad) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  boost::filesystem::path file_path(*test_dir / "cache" / "bootstrap_cache");
+  EndPointVector ranked;
+  {
+    BootstrapCache cache(file_path);
+    cache.Seen(MakeEndPoint(1));
+    Tick();
+    cache.Seen(MakeEndPoint(2));
+    cache.RecordRtt(MakeEndPoint(1), std::chrono::milliseconds(10));
+    ranked = cache.Ranked();
+    cache.Save();
+  }
+  BootstrapCache cache(file_path);
+  EXPECT_EQ(ranked, cache.Ranked());
+}
+
+TEST(BootstrapCacheTest, BEH_UnparseableFileIsReplaced) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  boost::filesystem::path file_path(*test_dir / "bootstrap_cache");
+  ASSERT_TRUE(WriteFile(file_path, "Not a bootstrap cache"));
+  {
+    BootstrapCache cache(file_path);
+    EXPECT_TRUE(cache.Ranked().empty());
+    cache.Seen(MakeEndPoint(1));
+    cache.Save();
+  }
+  BootstrapCache cache(file_path);
+  EXPECT_EQ(EndPointVector(1, MakeEndPoint(1)), cache.Ranked());
+}
+
+TEST(BootstrapCacheTest, BEH_ClientsSharingFileKeepEachOthersEntries) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapCache"));
+  boost::filesystem::path file_path(*test_dir / "bootstrap_cache");
+  {
+    BootstrapCache cache(file_path);
+    cache.Seen(MakeEndPoint(1));
+    cache.Save();
+  }
+  // Both load the same file, then each learns different endpoints before saving.
+  BootstrapCache first(file_path), second(file_path);
+  Tick();
+  first.Seen(MakeEndPoint(2));
+  first.RecordRtt(MakeEndPoint(2), std::chrono::milliseconds(30));
+  second.Seen(MakeEndPoint(3));
+  second.RecordRtt(MakeEndPoint(3), std::chrono::milliseconds(20));
+  Tick();
+  second.Seen(MakeEndPoint(1));
+  std::thread first_save([&first] { first.Save(); });
+  std::thread second_save([&second] { second.Save(); });
+  first_save.join();
+  second_save.join();
+
+  BootstrapCache cache(file_path);
+  EndPointVector expected;
+  expected.push_back(MakeEndPoint(3));
+  expected.push_back(MakeEndPoint(2));
+  expected.push_back(MakeEndPoint(1));
+  EXPECT_EQ(expected, cache.Ranked());
+  // Re-saving with nothing new keeps the entries saved by the other client.
+  first.Save();
+  EXPECT_EQ(expected, BootstrapCache(file_path).Ranked());
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,133 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/credential_rotation.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+typedef RotationJournal::Mid Mid;
+typedef RotationJournal::Tmid Tmid;
+
+Mid::Name RandomMidName() {
+  return Mid::Name(Identity(RandomString(64)));
+}
+
+Tmid::Name RandomTmidName() {
+  return Tmid::Name(Identity(RandomString(64)));
+}
+
+}  // unnamed namespace
+
+class RotationJournalTest : public testing::Test {
+ protected:
+  RotationJournalTest()
+      : test_dir_(maidsafe::test::CreateTestPath("MaidSafe_TestRotationJournal")),
+        file_path_(*test_dir_ / "rotation_journal" / "account") {}
+
+  maidsafe::test::TestPath test_dir_;
+  boost::filesystem::path file_path_;
+};
+
+TEST_F(RotationJournalTest, BEH_AddAndRemove) {
+  RotationJournal journal(file_path_);
+  EXPECT_TRUE(journal.Entries().empty());
+  Mid::Name first(RandomMidName()), second(RandomMidName());
+  Tmid::Name tmid_name(RandomTmidName());
+
+  // A MID is journalled before its TMID's name is known, and the name is filled in later.
+  journal.Add(first);
+  journal.Add(second);
+  ASSERT_EQ(2U, journal.Entries().size());
+  EXPECT_FALSE(journal.Entries()[0].second.data.IsInitialised());
+  journal.Add(first, tmid_name);
+  std::vector<RotationJournal::Entry> entries(journal.Entries());
+  ASSERT_EQ(2U, entries.size());
+  EXPECT_TRUE(entries[0].first == first);
+  EXPECT_TRUE(entries[0].second == tmid_name);
+
+  journal.Remove(first);
+  entries = journal.Entries();
+  ASSERT_EQ(1U, entries.size());
+  EXPECT_TRUE(entries[0].first == second);
+  // Removing the last entry removes the file too.
+  journal.Remove(second);
+  EXPECT_TRUE(journal.Entries().empty());
+  EXPECT_FALSE(boost::filesystem::exists(file_path_));
+}
+
+TEST_F(RotationJournalTest, BEH_EntriesSurviveRestart) {
+  Mid::Name mid_name(RandomMidName());
+  Tmid::Name tmid_name(RandomTmidName());
+  {
+    RotationJournal journal(file_path_);
+    journal.Add(mid_name, tmid_name);
+  }
+  // As after a crash before the deletion finished.
+  RotationJournal journal(file_path_);
+  std::vector<RotationJournal::Entry> entries(journal.Entries());
+  ASSERT_EQ(1U, entries.size());
+  EXPECT_TRUE(entries[0].first == mid_name);
+  EXPECT_TRUE(entries[0].second == tmid_name);
+}
+
+TEST_F(RotationJournalTest, BEH_ResumableEntriesDropTheLiveMid) {
+  Mid::Name live(RandomMidName()), replaced(RandomMidName());
+  Tmid::Name tmid_name(RandomTmidName());
+  {
+    RotationJournal journal(file_path_);
+    // A rotation away from 'live' which never stored its new credentials, and a completed one
+    // whose deletion was interrupted.
+    journal.Add(live);
+    journal.Add(replaced, tmid_name);
+  }
+  RotationJournal journal(file_path_);
+  std::vector<RotationJournal::Entry> resumable(journal.ResumableEntries(live));
+  ASSERT_EQ(1U, resumable.size());
+  EXPECT_TRUE(resumable[0].first == replaced);
+  EXPECT_TRUE(resumable[0].second == tmid_name);
+  // The live MID's entry is gone for good, while the other stays until its deletion succeeds.
+  std::vector<RotationJournal::Entry> entries(RotationJournal(file_path_).Entries());
+  ASSERT_EQ(1U, entries.size());
+  EXPECT_TRUE(entries[0].first == replaced);
+  EXPECT_EQ(1U, journal.ResumableEntries(RandomMidName()).size());
+}
+
+TEST_F(RotationJournalTest, BEH_JournalsAreKeptPerAccount) {
+  RotationJournal journal(file_path_);
+  journal.Add(RandomMidName(), RandomTmidName());
+  RotationJournal other_account(file_path_.parent_path() / "other_account");
+  EXPECT_TRUE(other_account.Entries().empty());
+  EXPECT_EQ(1U, journal.Entries().size());
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
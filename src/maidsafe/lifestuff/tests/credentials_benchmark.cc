@@ -0,0 +1,182 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/lifestuff/detail/session.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+template <typename Input>
+std::unique_ptr<Input> MakeInput(const std::string& characters) {
+  std::unique_ptr<Input> input(new Input());
+  input->Insert(0, characters);
+  input->Finalise();
+  return input;
+}
+
+void InitialiseSession(Session& session, int64_t storage_path_size) {
+  session.passport().CreateFobs();
+  session.passport().ConfirmFobs();
+  session.set_passport_modified();
+  session.set_unique_user_id(Identity(RandomAlphaNumericString(64)));
+  session.set_drive_root_id(RandomAlphaNumericString(64));
+  session.set_storage_path(RandomAlphaNumericString(static_cast<size_t>(storage_path_size)));
+}
+
+// Argument: length of the session's storage path, as a proxy for its user data size.
+void BM_SessionSerialise(benchmark::State& state) {
+  Session session;
+  InitialiseSession(session, state.range(0));
+  int64_t used_space(0);
+  for (auto _ : state) {
+    // Modify the session each time, otherwise the previous result is simply returned.
+    session.set_used_space(++used_space);
+    benchmark::DoNotOptimize(session.Serialise());
+    session.MarkSaved();
+  }
+}
+BENCHMARK(BM_SessionSerialise)->Arg(16)->Arg(256)->Arg(4096);
+
+// As above, but also re-serialising the passport keyring each time.
+void BM_SessionSerialiseWithKeyring(benchmark::State& state) {
+  Session session;
+  InitialiseSession(session, state.range(0));
+  for (auto _ : state) {
+    session.set_passport_modified();
+    benchmark::DoNotOptimize(session.Serialise());
+    session.MarkSaved();
+  }
+}
+BENCHMARK(BM_SessionSerialiseWithKeyring)->Arg(16)->Arg(256)->Arg(4096);
+
+// Second argument: whether the keyring is decoded after parsing, as happens at login.
+void BM_SessionParse(benchmark::State& state) {
+  Session original;
+  InitialiseSession(original, state.range(0));
+  NonEmptyString serialised_session(original.Serialise());
+  for (auto _ : state) {
+    Session session;
+    session.Parse(serialised_session);
+    if (state.range(1))
+      benchmark::DoNotOptimize(session.passport().Get<passport::Maid>(true));
+  }
+  state.SetBytesProcessed(state.iterations() * serialised_session.string().size());
+}
+BENCHMARK(BM_SessionParse)->ArgsProduct({ { 16, 4096 }, { 0, 1 } });
+
+// Argument: keyword length.
+void BM_MidName(benchmark::State& state) {
+  auto keyword(MakeInput<Keyword>(RandomAlphaNumericString(static_cast<size_t>(state.range(0)))));
+  auto pin(MakeInput<Pin>("1234"));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(passport::MidName(*keyword, *pin));
+}
+BENCHMARK(BM_MidName)->Arg(8)->Arg(32)->Arg(128);
+
+void BM_EncryptTmidName(benchmark::State& state) {
+  auto keyword(MakeInput<Keyword>(RandomAlphaNumericString(static_cast<size_t>(state.range(0)))));
+  auto pin(MakeInput<Pin>("1234"));
+  passport::Tmid::Name tmid_name(Identity(RandomString(64)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(passport::EncryptTmidName(*keyword, *pin, tmid_name));
+}
+BENCHMARK(BM_EncryptTmidName)->Arg(8)->Arg(32)->Arg(128);
+
+// Argument: size in bytes of the serialised session being encrypted.
+void BM_EncryptSession(benchmark::State& state) {
+  auto keyword(MakeInput<Keyword>("keyword"));
+  auto pin(MakeInput<Pin>("1234"));
+  auto password(MakeInput<Password>("password"));
+  NonEmptyString serialised_session(RandomString(static_cast<size_t>(state.range(0))));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        passport::EncryptSession(*keyword, *pin, *password, serialised_session));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EncryptSession)->RangeMultiplier(4)->Range(1 << 10, 1 << 18);
+
+void BM_DecryptSession(benchmark::State& state) {
+  auto keyword(MakeInput<Keyword>("keyword"));
+  auto pin(MakeInput<Pin>("1234"));
+  auto password(MakeInput<Password>("password"));
+  passport::EncryptedSession encrypted_session(passport::EncryptSession(
+      *keyword, *pin, *password, NonEmptyString(RandomString(
+                                     static_cast<size_t>(state.range(0))))));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        passport::DecryptSession(*keyword, *pin, *password, encrypted_session));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DecryptSession)->RangeMultiplier(4)->Range(1 << 10, 1 << 18);
+
+void BM_CreateFobs(benchmark::State& state) {
+  for (auto _ : state) {
+    passport::Passport passport;
+    passport.CreateFobs();
+  }
+}
+BENCHMARK(BM_CreateFobs)->Unit(benchmark::kMillisecond);
+
+void BM_ConfirmFobs(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    passport::Passport passport;
+    passport.CreateFobs();
+    state.ResumeTiming();
+    passport.ConfirmFobs();
+  }
+}
+BENCHMARK(BM_ConfirmFobs);
+
+}  // unnamed namespace
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
+
+// Results are written as JSON unless another format is requested.
+int main(int argc, char** argv) {
+  std::vector<char*> arguments(argv, argv + argc);
+  bool format_given(false);
+  for (int i(1); i < argc; ++i)
+    format_given = format_given || std::string(argv[i]).find("--benchmark_format") == 0;
+  char json_format[] = "--benchmark_format=json";
+  if (!format_given)
+    arguments.push_back(json_format);
+  int argument_count(static_cast<int>(arguments.size()));
+  benchmark::Initialize(&argument_count, arguments.data());
+  if (benchmark::ReportUnrecognizedArguments(argument_count, arguments.data()))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
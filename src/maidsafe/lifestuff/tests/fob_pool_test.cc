@@ -0,0 +1,132 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/lifestuff/detail/fob_pool.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+// Counts the passports generated, optionally holding each until 'released' is ready.
+struct Generation {
+  Generation() : generated(0), released() {}
+  std::atomic<int> generated;
+  std::shared_future<void> released;
+};
+
+FobPool::Generator MakeGenerator(std::shared_ptr<Generation> generation) {
+  return [generation]() {
+      ++generation->generated;
+      if (generation->released.valid())
+        generation->released.wait();
+      return FobPool::PassportPtr(new passport::Passport());
+    };
+}
+
+// Polls 'condition' for up to five seconds.
+bool Eventually(std::function<bool()> condition) {
+  std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now() +
+                                                 std::chrono::seconds(5));
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+}  // unnamed namespace
+
+TEST(FobPoolTest, BEH_MissBeforeStart) {
+  std::shared_ptr<Generation> generation(std::make_shared<Generation>());
+  FobPool fob_pool(2, 1, MakeGenerator(generation));
+  EXPECT_TRUE(fob_pool.Take() != nullptr);
+  FobPool::Metrics metrics(fob_pool.metrics());
+  EXPECT_EQ(0U, metrics.hits);
+  EXPECT_EQ(0U, metrics.waits);
+  EXPECT_EQ(1U, metrics.misses);
+  EXPECT_EQ(0U, metrics.ready);
+  EXPECT_EQ(1, generation->generated);
+}
+
+TEST(FobPoolTest, BEH_ZeroDepthNeverPregenerates) {
+  std::shared_ptr<Generation> generation(std::make_shared<Generation>());
+  FobPool fob_pool(0, 1, MakeGenerator(generation));
+  fob_pool.Start();
+  EXPECT_TRUE(fob_pool.Take() != nullptr);
+  EXPECT_EQ(1U, fob_pool.metrics().misses);
+  EXPECT_EQ(1, generation->generated);
+}
+
+TEST(FobPoolTest, BEH_FillsToDepthAndRefillsAfterHit) {
+  std::shared_ptr<Generation> generation(std::make_shared<Generation>());
+  FobPool fob_pool(3, 2, MakeGenerator(generation));
+  fob_pool.Start();
+  ASSERT_TRUE(Eventually([&] { return fob_pool.metrics().ready == 3; }));
+  EXPECT_EQ(3, generation->generated);
+  // Start is idempotent.
+  fob_pool.Start();
+
+  EXPECT_TRUE(fob_pool.Take() != nullptr);
+  EXPECT_EQ(1U, fob_pool.metrics().hits);
+  ASSERT_TRUE(Eventually([&] { return fob_pool.metrics().ready == 3; }));
+  // The pool never holds more than its depth, however often it is topped up.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(4, generation->generated);
+  EXPECT_EQ(3U, fob_pool.metrics().ready);
+  EXPECT_EQ(0U, fob_pool.metrics().misses);
+}
+
+TEST(FobPoolTest, BEH_TakeWaitsForGenerationInProgress) {
+  std::promise<void> release;
+  std::shared_ptr<Generation> generation(std::make_shared<Generation>());
+  generation->released = release.get_future().share();
+  FobPool fob_pool(1, 1, MakeGenerator(generation));
+  fob_pool.Start();
+  ASSERT_TRUE(Eventually([&] { return generation->generated == 1; }));
+
+  std::future<FobPool::PassportPtr> taken(std::async(std::launch::async, [&fob_pool] {
+                                                       return fob_pool.Take();
+                                                     }));
+  EXPECT_EQ(std::future_status::timeout, taken.wait_for(std::chrono::milliseconds(100)));
+  release.set_value();
+  EXPECT_TRUE(taken.get() != nullptr);
+  FobPool::Metrics metrics(fob_pool.metrics());
+  EXPECT_EQ(0U, metrics.hits);
+  EXPECT_EQ(1U, metrics.waits);
+  EXPECT_EQ(0U, metrics.misses);
+  // The only other passport generated is the one topping the pool up again.
+  ASSERT_TRUE(Eventually([&] { return fob_pool.metrics().ready == 1; }));
+  EXPECT_EQ(2, generation->generated);
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
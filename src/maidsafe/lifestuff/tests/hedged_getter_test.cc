@@ -0,0 +1,127 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/hedged_getter.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+Identity RandomName() {
+  return Identity(RandomString(64));
+}
+
+std::chrono::milliseconds Elapsed(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+}
+
+HedgedGetOptions FastHedging() {
+  HedgedGetOptions options;
+  options.initial_hedge_delay = std::chrono::milliseconds(20);
+  options.shutdown_timeout = std::chrono::milliseconds(50);
+  return options;
+}
+
+// Blocks the attempts given to it until released, or until the test ends.
+class Gate {
+ public:
+  Gate() : promise_(std::make_shared<std::promise<void>>()),
+           released_(promise_->get_future().share()) {}
+  ~Gate() { Release(); }
+  void Release() {
+    if (promise_) {
+      promise_->set_value();
+      promise_.reset();
+    }
+  }
+  std::shared_future<void> released() const { return released_; }
+
+ private:
+  std::shared_ptr<std::promise<void>> promise_;
+  std::shared_future<void> released_;
+};
+
+}  // unnamed namespace
+
+TEST(HedgedGetterTest, BEH_HedgeAnswersWhenFirstHolderStalls) {
+  Gate gate;
+  std::shared_future<void> released(gate.released());
+  HedgedGetter getter([released](const Identity& /*name*/, uint32_t holder) {
+                        if (holder == 0)
+                          released.wait();
+                        return NonEmptyString("holder " + std::to_string(holder));
+                      },
+                      FastHedging());
+  Clock::time_point start(Clock::now());
+  EXPECT_EQ(NonEmptyString("holder 1"), getter.Get(RandomName(), std::chrono::seconds(10)));
+  EXPECT_LT(Elapsed(start), std::chrono::seconds(5));
+  HedgedGetter::Metrics metrics(getter.metrics());
+  EXPECT_EQ(1U, metrics.gets);
+  EXPECT_EQ(1U, metrics.hedged);
+  EXPECT_EQ(1U, metrics.hedge_wins);
+  gate.Release();
+}
+
+TEST(HedgedGetterTest, BEH_DeadlineAndAbandonedShutdown) {
+  Gate gate;
+  std::shared_future<void> released(gate.released());
+  Clock::time_point start(Clock::now());
+  {
+    HedgedGetter getter([released](const Identity& /*name*/, uint32_t /*holder*/) {
+                          released.wait();
+                          return NonEmptyString("late");
+                        },
+                        FastHedging());
+    EXPECT_THROW(getter.Get(RandomName(), std::chrono::milliseconds(100)), std::exception);
+    EXPECT_GE(Elapsed(start), std::chrono::milliseconds(100));
+    EXPECT_EQ(1U, getter.metrics().timeouts);
+    EXPECT_EQ(1U, getter.metrics().hedged);
+  }
+  // Destruction abandons the stalled requests after 'shutdown_timeout' rather than waiting.
+  EXPECT_LT(Elapsed(start), std::chrono::seconds(5));
+  gate.Release();
+}
+
+TEST(HedgedGetterTest, BEH_RethrowsWhenAllHoldersFail) {
+  HedgedGetter getter([](const Identity& /*name*/, uint32_t /*holder*/) -> NonEmptyString {
+                        throw std::runtime_error("no such data");
+                      },
+                      FastHedging());
+  EXPECT_THROW(getter.Get(RandomName(), std::chrono::seconds(10)), std::runtime_error);
+  EXPECT_EQ(1U, getter.metrics().failures);
+  EXPECT_EQ(0U, getter.metrics().timeouts);
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,155 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/lifestuff/detail/join_race.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// What happened to the racers made by one factory.
+struct RacerLog {
+  RacerLog() : mutex(), destroyed(0), cancelled(0) {}
+  std::mutex mutex;
+  int destroyed, cancelled;
+};
+
+// Joins after 'join_delay' unless destroyed first, which counts as cancelling it.
+class FakeRacer : public JoinRacer {
+ public:
+  FakeRacer(std::chrono::milliseconds join_delay, std::shared_ptr<RacerLog> log)
+      : join_delay_(join_delay), log_(log), mutex_(), condition_variable_(), cancelled_(false),
+        joined_(false), thread_() {}
+
+  ~FakeRacer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_ = true;
+    }
+    condition_variable_.notify_all();
+    if (thread_.joinable())
+      thread_.join();
+    std::lock_guard<std::mutex> lock(log_->mutex);
+    ++log_->destroyed;
+    if (!joined_)
+      ++log_->cancelled;
+  }
+
+  virtual void Join(const RoutingHandler::EndPointVector& /*endpoints*/,
+                    const RoutingHandler::JoinObservers& join_observers) {
+    thread_ = std::thread([this, join_observers] {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          if (condition_variable_.wait_for(lock, join_delay_, [this] { return cancelled_; }))
+            return;
+          joined_ = true;
+        }
+        join_observers.joined(join_delay_);
+      });
+  }
+
+ private:
+  FakeRacer(const FakeRacer&);
+  FakeRacer& operator=(const FakeRacer&);
+
+  const std::chrono::milliseconds join_delay_;
+  std::shared_ptr<RacerLog> log_;
+  std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  bool cancelled_, joined_;
+  std::thread thread_;
+};
+
+RoutingHandler::EndPointVector MakeEndpoints(size_t count) {
+  RoutingHandler::EndPointVector endpoints;
+  for (size_t i(0); i != count; ++i)
+    endpoints.push_back(std::make_pair("192.168.0.1", static_cast<uint16_t>(5483 + i)));
+  return endpoints;
+}
+
+RacerFactory MakeFactory(const std::vector<std::chrono::milliseconds>& join_delays,
+                         std::shared_ptr<RacerLog> log) {
+  return [join_delays, log](size_t racer) {
+      return JoinRacerPtr(new FakeRacer(join_delays.at(racer), log));
+    };
+}
+
+}  // unnamed namespace
+
+TEST(JoinRaceTest, BEH_FastestEndpointWinsAndLosersAreCancelled) {
+  // The third endpoint joins well before the first two, but only once it has been started.
+  std::chrono::milliseconds slow(std::chrono::seconds(5)), fast(50);
+  std::vector<std::chrono::milliseconds> join_delays;
+  join_delays.push_back(slow);
+  join_delays.push_back(slow);
+  join_delays.push_back(fast);
+  join_delays.push_back(slow);
+  std::shared_ptr<RacerLog> log(std::make_shared<RacerLog>());
+  RoutingHandler::EndPointVector endpoints(MakeEndpoints(join_delays.size()));
+  JoinReport join_report;
+  Clock::time_point start(Clock::now());
+  EXPECT_TRUE(RaceBootstrap(MakeFactory(join_delays, log), endpoints,
+                            RoutingHandler::JoinObservers(), join_report));
+  EXPECT_LT(Clock::now() - start, slow);
+
+  ASSERT_EQ(2, join_report.winner);
+  EXPECT_EQ(endpoints[2], join_report.attempts[2].endpoint);
+  EXPECT_TRUE(join_report.attempts[2].joined);
+  EXPECT_EQ(fast, join_report.attempts[2].join_time);
+  // The fourth endpoint is never tried, and the racers which were started are all destroyed,
+  // cancelling those still joining.
+  EXPECT_EQ(3U, join_report.attempts.size());
+  EXPECT_FALSE(join_report.attempts[0].joined);
+  EXPECT_FALSE(join_report.attempts[1].joined);
+  EXPECT_GE(join_report.attempts[1].started_after, kJoinRaceStagger);
+  EXPECT_EQ(3, log->destroyed);
+  EXPECT_EQ(2, log->cancelled);
+}
+
+TEST(JoinRaceTest, BEH_NoFurtherAttemptsOnceOneJoins) {
+  std::vector<std::chrono::milliseconds> join_delays(kJoinRaceWidth,
+                                                     std::chrono::milliseconds(10));
+  std::shared_ptr<RacerLog> log(std::make_shared<RacerLog>());
+  RoutingHandler::EndPointVector endpoints(MakeEndpoints(join_delays.size()));
+  JoinReport join_report;
+  EXPECT_TRUE(RaceBootstrap(MakeFactory(join_delays, log), endpoints,
+                            RoutingHandler::JoinObservers(), join_report));
+  EXPECT_EQ(0, join_report.winner);
+  EXPECT_EQ(1U, join_report.attempts.size());
+  EXPECT_EQ(1, log->destroyed);
+  EXPECT_EQ(0, log->cancelled);
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
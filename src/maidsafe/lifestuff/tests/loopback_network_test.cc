@@ -0,0 +1,177 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/lifestuff/detail/client_maid.h"
+#include "maidsafe/lifestuff/detail/loopback_network.h"
+#include "maidsafe/lifestuff/detail/session.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+Identity RandomName() {
+  return Identity(RandomString(64));
+}
+
+std::chrono::milliseconds Elapsed(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+template <typename Input>
+std::unique_ptr<Input> MakeInput(const std::string& characters) {
+  std::unique_ptr<Input> input(new Input());
+  input->Insert(0, characters);
+  input->Finalise();
+  return input;
+}
+
+Slots TestSlots() {
+  Slots slots;
+  slots.update_available = [](const std::string&) {};
+  slots.network_health = [](int32_t) {};
+  slots.operations_pending = [](bool) {};
+  return slots;
+}
+
+}  // unnamed namespace
+
+TEST(LoopbackNetworkTest, BEH_PutGetDelete) {
+  LoopbackNetwork network((LoopbackNetworkOptions()));
+  Identity name(RandomName());
+  NonEmptyString content(RandomString(1024));
+  EXPECT_THROW(network.Get(name, 0), std::exception);
+  EXPECT_NO_THROW(network.Put(name, content));
+  EXPECT_EQ(1U, network.size());
+  EXPECT_EQ(content, network.Get(name, 0));
+  EXPECT_NO_THROW(network.Delete(name));
+  EXPECT_EQ(0U, network.size());
+  EXPECT_THROW(network.Get(name, 0), std::exception);
+  EXPECT_NO_THROW(network.Delete(name));
+
+  LoopbackNetwork::Metrics metrics(network.metrics());
+  EXPECT_EQ(1U, metrics.puts);
+  EXPECT_EQ(3U, metrics.gets);
+  EXPECT_EQ(2U, metrics.deletes);
+  EXPECT_EQ(1024U, metrics.bytes_sent);
+  EXPECT_EQ(1024U, metrics.bytes_received);
+}
+
+TEST(LoopbackNetworkTest, BEH_LatencyAndBandwidth) {
+  LoopbackNetworkOptions options;
+  options.hops = 2;
+  options.hop_latency = std::chrono::milliseconds(10);
+  LoopbackNetwork network(options);
+  Identity name(RandomName());
+  auto start(std::chrono::steady_clock::now());
+  network.Put(name, NonEmptyString(RandomString(1024)));
+  // Two hops each way.
+  EXPECT_GE(Elapsed(start), std::chrono::milliseconds(40));
+
+  options.hops = 0;
+  options.bandwidth = 1024 * 1024;
+  LoopbackNetwork limited_network(options);
+  start = std::chrono::steady_clock::now();
+  limited_network.Put(name, NonEmptyString(RandomString(100 * 1024)));
+  EXPECT_GE(Elapsed(start), std::chrono::milliseconds(97));
+}
+
+TEST(LoopbackNetworkTest, BEH_Loss) {
+  LoopbackNetworkOptions options;
+  options.loss = 1.0;
+  options.timeout = std::chrono::milliseconds(50);
+  LoopbackNetwork network(options);
+  Identity name(RandomName());
+  auto start(std::chrono::steady_clock::now());
+  EXPECT_THROW(network.Put(name, NonEmptyString(RandomString(1024))), std::exception);
+  EXPECT_GE(Elapsed(start), options.timeout);
+  EXPECT_EQ(0U, network.size());
+  EXPECT_EQ(1U, network.metrics().lost);
+
+  // The same seed loses the same messages for the same sequence of requests.
+  options.loss = 0.5;
+  options.seed = 7;
+  options.timeout = std::chrono::milliseconds(0);
+  LoopbackNetwork first(options), second(options);
+  for (int i(0); i != 20; ++i) {
+    NodeId node_id(NodeId::kRandomId);
+    bool first_lost(false), second_lost(false);
+    try { first.Join(node_id); } catch(...) { first_lost = true; }
+    try { second.Join(node_id); } catch(...) { second_lost = true; }
+    EXPECT_EQ(first_lost, second_lost);
+  }
+}
+
+TEST(LoopbackNetworkTest, FUNC_CreateUserAndLogIn) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestLoopback"));
+  LoopbackNetworkOptions options;
+  options.hop_latency = std::chrono::milliseconds(1);
+  std::shared_ptr<LoopbackNetwork> network(std::make_shared<LoopbackNetwork>(options));
+  ClientOptions client_options;
+  client_options.bootstrap_cache_path = (*test_dir / "bootstrap_cache").string();
+  client_options.public_key_cache_path = (*test_dir / "public_key_cache").string();
+  auto keyword(MakeInput<Keyword>("keyword"));
+  auto pin(MakeInput<Pin>("1234"));
+  auto password(MakeInput<Password>("password"));
+  ReportProgressFunction report_progress([](Action, ProgressCode) {});
+  Identity unique_user_id;
+  {
+    Session session;
+    ClientMaid client_maid(session, TestSlots(), client_options);
+    client_maid.UseNetwork(network);
+    ASSERT_NO_THROW(client_maid.CreateUser(*keyword, *pin, *password, *test_dir / "vault",
+                                           report_progress));
+    unique_user_id = session.unique_user_id();
+  }
+  EXPECT_EQ(1U, network->metrics().vaults_started);
+  EXPECT_LT(0U, network->size());
+  {
+    Session session;
+    ClientMaid client_maid(session, TestSlots(), client_options);
+    client_maid.UseNetwork(network);
+    ASSERT_NO_THROW(client_maid.LogIn(*keyword, *pin, *password, *test_dir / "vault",
+                                      report_progress));
+    EXPECT_EQ(unique_user_id, session.unique_user_id());
+    auto wrong_pin(MakeInput<Pin>("4321"));
+    Session other_session;
+    ClientMaid other_client_maid(other_session, TestSlots(), client_options);
+    other_client_maid.UseNetwork(network);
+    EXPECT_THROW(other_client_maid.LogIn(*keyword, *wrong_pin, *password, *test_dir / "vault",
+                                         report_progress),
+                 std::exception);
+  }
+  EXPECT_EQ(2U, network->metrics().vaults_started);
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -0,0 +1,227 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/lifestuff/detail/public_key_cache.h"
+
+namespace maidsafe {
+namespace lifestuff {
+namespace test {
+
+namespace {
+
+const std::chrono::seconds kWaitTimeout(10);
+
+struct Node {
+  Node() : node_id(), record() {
+    record.public_key = asymm::GenerateKeyPair().public_key;
+    record.validation_token = RandomString(64);
+    node_id = NodeId(crypto::Hash<crypto::SHA512>(
+        asymm::EncodeKey(record.public_key).string() + record.validation_token).string());
+  }
+  NodeId node_id;
+  PublicKeyCache::KeyRecord record;
+};
+
+// Returns the key given for 'node_id', waiting up to kWaitTimeout for a fetch to complete.
+bool GetKey(PublicKeyCache& cache, const NodeId& node_id, asymm::PublicKey& public_key) {
+  std::shared_ptr<std::promise<asymm::PublicKey>> promise(
+      std::make_shared<std::promise<asymm::PublicKey>>());
+  std::future<asymm::PublicKey> future(promise->get_future());
+  cache.Get(node_id, [promise](asymm::PublicKey key) { promise->set_value(key); });
+  if (future.wait_for(kWaitTimeout) != std::future_status::ready)
+    return false;
+  public_key = future.get();
+  return true;
+}
+
+}  // unnamed namespace
+
+class PublicKeyCacheTest : public testing::Test {
+ protected:
+  PublicKeyCacheTest()
+      : nodes_(3),
+        fetches_(0),
+        fetch_([this](const NodeId& node_id) -> PublicKeyCache::KeyRecord {
+                 ++fetches_;
+                 for (auto& node : nodes_) {
+                   if (node.node_id == node_id)
+                     return node.record;
+                 }
+                 ThrowError(CommonErrors::no_such_element);
+                 return PublicKeyCache::KeyRecord();
+               }) {}
+
+  std::vector<Node> nodes_;
+  std::atomic<int> fetches_;
+  PublicKeyCache::FetchFunctor fetch_;
+};
+
+TEST_F(PublicKeyCacheTest, BEH_ConcurrentMissesShareOneFetch) {
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future());
+  PublicKeyCache cache([this, released](const NodeId& node_id) {
+                         released.wait();
+                         return fetch_(node_id);
+                       },
+                       PublicKeyCacheOptions());
+  const int kRequests(5);
+  std::atomic<int> given(0);
+  std::promise<void> all_given;
+  for (int i(0); i != kRequests; ++i) {
+    cache.Get(nodes_[0].node_id, [&](asymm::PublicKey public_key) {
+                EXPECT_TRUE(asymm::MatchingKeys(nodes_[0].record.public_key, public_key));
+                if (++given == kRequests)
+                  all_given.set_value();
+              });
+  }
+  release.set_value();
+  ASSERT_EQ(std::future_status::ready, all_given.get_future().wait_for(kWaitTimeout));
+  EXPECT_EQ(1, fetches_);
+  PublicKeyCache::Metrics metrics(cache.metrics());
+  EXPECT_EQ(static_cast<uint64_t>(kRequests), metrics.misses);
+  EXPECT_EQ(static_cast<uint64_t>(kRequests - 1), metrics.coalesced);
+
+  asymm::PublicKey public_key;
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  EXPECT_EQ(1, fetches_);
+  EXPECT_EQ(1U, cache.metrics().hits);
+}
+
+TEST_F(PublicKeyCacheTest, BEH_ExpiredKeysAreFetchedAgain) {
+  PublicKeyCacheOptions options;
+  options.time_to_live = std::chrono::milliseconds(50);
+  PublicKeyCache cache(fetch_, options);
+  asymm::PublicKey public_key;
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  EXPECT_EQ(1, fetches_);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  EXPECT_EQ(2, fetches_);
+  EXPECT_TRUE(asymm::MatchingKeys(nodes_[0].record.public_key, public_key));
+}
+
+TEST_F(PublicKeyCacheTest, BEH_LeastRecentlyUsedKeyIsEvicted) {
+  PublicKeyCacheOptions options;
+  options.capacity = 2;
+  PublicKeyCache cache(fetch_, options);
+  asymm::PublicKey public_key;
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  ASSERT_TRUE(GetKey(cache, nodes_[1].node_id, public_key));
+  // Makes nodes_[1] the least recently used.
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  ASSERT_TRUE(GetKey(cache, nodes_[2].node_id, public_key));
+  EXPECT_EQ(3, fetches_);
+  EXPECT_EQ(1U, cache.metrics().evictions);
+
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  EXPECT_EQ(3, fetches_);
+  ASSERT_TRUE(GetKey(cache, nodes_[1].node_id, public_key));
+  EXPECT_EQ(4, fetches_);
+}
+
+TEST_F(PublicKeyCacheTest, BEH_MismatchedKeyIsNotGiven) {
+  PublicKeyCache cache([this](const NodeId& /*node_id*/) { return nodes_[1].record; },
+                       PublicKeyCacheOptions());
+  std::atomic<bool> given(false);
+  cache.Get(nodes_[0].node_id, [&given](asymm::PublicKey /*public_key*/) { given = true; });
+  auto deadline(std::chrono::steady_clock::now() + kWaitTimeout);
+  while (cache.metrics().failures == 0 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(1U, cache.metrics().failures);
+  EXPECT_FALSE(given);
+}
+
+TEST_F(PublicKeyCacheTest, BEH_SaveAndLoad) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestPublicKeyCache"));
+  PublicKeyCacheOptions options;
+  options.file_path = *test_dir / "public_key_cache";
+  asymm::PublicKey public_key;
+  {
+    PublicKeyCache cache(fetch_, options);
+    ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+    ASSERT_TRUE(GetKey(cache, nodes_[1].node_id, public_key));
+    cache.Save();
+  }
+  {
+    PublicKeyCache cache(fetch_, options);
+    ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+    ASSERT_TRUE(GetKey(cache, nodes_[1].node_id, public_key));
+    EXPECT_TRUE(asymm::MatchingKeys(nodes_[1].record.public_key, public_key));
+    EXPECT_EQ(2, fetches_);
+    EXPECT_EQ(2U, cache.metrics().hits);
+  }
+
+  // Entries whose key does not match their node id are discarded, as if tampered with.
+  std::string content;
+  ASSERT_TRUE(ReadFile(options.file_path, &content));
+  std::string node_id(nodes_[0].node_id.string());
+  std::string other_node_id(nodes_[2].node_id.string());
+  size_t position(content.find(node_id));
+  ASSERT_NE(std::string::npos, position);
+  content.replace(position, node_id.size(), other_node_id);
+  ASSERT_TRUE(WriteFile(options.file_path, content));
+  {
+    PublicKeyCache cache(fetch_, options);
+    ASSERT_TRUE(GetKey(cache, nodes_[2].node_id, public_key));
+    EXPECT_TRUE(asymm::MatchingKeys(nodes_[2].record.public_key, public_key));
+    EXPECT_EQ(3, fetches_);
+    EXPECT_EQ(1U, cache.metrics().misses);
+  }
+}
+
+TEST_F(PublicKeyCacheTest, BEH_ClientsSharingFileKeepEachOthersKeys) {
+  maidsafe::test::TestPath test_dir(maidsafe::test::CreateTestPath("MaidSafe_TestPublicKeyCache"));
+  PublicKeyCacheOptions options;
+  options.file_path = *test_dir / "public_key_cache";
+  asymm::PublicKey public_key;
+  {
+    // Both start from the same, empty file and each fetches a different key before saving.
+    PublicKeyCache first(fetch_, options), second(fetch_, options);
+    ASSERT_TRUE(GetKey(first, nodes_[0].node_id, public_key));
+    ASSERT_TRUE(GetKey(second, nodes_[1].node_id, public_key));
+    std::thread first_save([&first] { first.Save(); });
+    std::thread second_save([&second] { second.Save(); });
+    first_save.join();
+    second_save.join();
+    first.Save();
+  }
+  PublicKeyCache cache(fetch_, options);
+  ASSERT_TRUE(GetKey(cache, nodes_[0].node_id, public_key));
+  ASSERT_TRUE(GetKey(cache, nodes_[1].node_id, public_key));
+  EXPECT_EQ(2, fetches_);
+  EXPECT_EQ(2U, cache.metrics().hits);
+}
+
+}  // namespace test
+}  // namespace lifestuff
+}  // namespace maidsafe
@@ -16,6 +16,9 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <map>
+#include <vector>
+
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
@@ -250,6 +253,76 @@ TEST_F(UserInputTest, BEH_InvalidInputField) {
   EXPECT_TRUE(lifestuff_->ConfirmUserInput(kPassword));
 }
 
+TEST_F(UserInputTest, BEH_InvalidCharacters) {
+  EXPECT_THROW(lifestuff_->InsertUserInput(0, "a", kPin), common_error);
+  EXPECT_THROW(lifestuff_->InsertUserInput(0, "1a", kPin), common_error);
+  EXPECT_NO_THROW(lifestuff_->InsertUserInput(0, "0", kPin));
+  EXPECT_NO_THROW(lifestuff_->InsertUserInput(1, "12", kPin));
+  EXPECT_THROW(lifestuff_->InsertUserInput(3, "\t", kPassword), common_error);
+  EXPECT_THROW(lifestuff_->InsertUserInput(0, std::string(101, 'k'), kKeyword), common_error);
+  EXPECT_THROW(lifestuff_->InsertUserInput(100, "k", kKeyword), common_error);
+
+  EXPECT_TRUE(lifestuff_->ConfirmUserInput(kPin));
+}
+
+TEST_F(UserInputTest, BEH_InputSizeLimit) {
+  EXPECT_NO_THROW(lifestuff_->InsertUserInput(0, std::string(100, 'k'), kKeyword));
+  EXPECT_THROW(lifestuff_->InsertUserInput(0, "k", kKeyword), common_error);
+  EXPECT_NO_THROW(lifestuff_->RemoveUserInput(99, 1, kKeyword));
+  EXPECT_NO_THROW(lifestuff_->InsertUserInput(99, "k", kKeyword));
+  EXPECT_TRUE(lifestuff_->ConfirmUserInput(kKeyword));
+
+  EXPECT_NO_THROW(lifestuff_->InsertUserInput(0, "01234", kPin));
+  EXPECT_THROW(lifestuff_->InsertUserInput(0, "567890", kPin), common_error);
+  EXPECT_NO_THROW(lifestuff_->InsertUserInput(5, "56789", kPin));
+}
+
+TEST_F(UserInputTest, BEH_ApplyUserInput) {
+  std::vector<UserInputEdit> edits(3);
+  edits[0].input_field = kPin;
+  edits[0].characters = "0123";
+  edits[1].input_field = kConfirmationPin;
+  edits[1].characters = "0123";
+  edits[2].input_field = kPassword;
+  edits[2].characters = "password";
+  EXPECT_NO_THROW(lifestuff_->ApplyUserInput(edits));
+  std::map<InputField, bool> results(lifestuff_->ConfirmAllUserInput());
+  EXPECT_EQ(3U, results.size());
+  EXPECT_TRUE(results[kPin]);
+  EXPECT_TRUE(results[kConfirmationPin]);
+  EXPECT_TRUE(results[kPassword]);
+
+  // An invalid edit anywhere in the batch leaves all fields unchanged.
+  edits.resize(2);
+  edits[0].input_field = kKeyword;
+  edits[0].characters = "keyword";
+  edits[1].input_field = kConfirmationPin;
+  edits[1].position = 4;
+  edits[1].characters = "x";
+  EXPECT_THROW(lifestuff_->ApplyUserInput(edits), common_error);
+  results = lifestuff_->ConfirmAllUserInput();
+  EXPECT_EQ(0U, results.count(kKeyword));
+  EXPECT_TRUE(results[kConfirmationPin]);
+
+  // Removals are checked against the input as left by the earlier edits of the batch.
+  edits[1].input_field = kPin;
+  edits[1].operation = kRemoveInput;
+  edits[1].position = 2;
+  edits[1].length = 3;
+  EXPECT_THROW(lifestuff_->ApplyUserInput(edits), common_error);
+  results = lifestuff_->ConfirmAllUserInput();
+  EXPECT_EQ(0U, results.count(kKeyword));
+  EXPECT_TRUE(results[kPin]);
+  edits[1].length = 2;
+  EXPECT_NO_THROW(lifestuff_->ApplyUserInput(edits));
+  EXPECT_TRUE(lifestuff_->ConfirmUserInput(kKeyword));
+  EXPECT_TRUE(lifestuff_->ConfirmUserInput(kPin));
+
+  EXPECT_THROW(lifestuff_->SetCredentials("keyword", "12a4", "password"), common_error);
+  EXPECT_NO_THROW(lifestuff_->SetCredentials("keyword", "1234", "password"));
+  EXPECT_TRUE(lifestuff_->ConfirmUserInput(kKeyword));
+}
+
 }  // namespace test
 }  // namespace lifestuff
 }  // namespace maidsafe
@@ -19,7 +19,6 @@
 #include <sstream>
 #include <thread>
 
-#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
@@ -46,6 +45,7 @@ class UserStorageTest : public testing::Test {
   UserStorageTest()
     : test_dir_(maidsafe::test::CreateTestPath()),
       mount_dir_(*test_dir_ / RandomAlphaNumericString(8)),
+      executor_(ExecutorOptions()),
       session_(),
       routing_handler_(),
       client_nfs_(),
@@ -61,12 +61,15 @@ class UserStorageTest : public testing::Test {
         LOG(kInfo) << "Public key requested.";
       });
     passport::Maid maid(session_.passport().Get<passport::Maid>(true));
-    routing_handler_.reset(new RoutingHandler(maid, public_key_request));
+    routing_handler_.reset(new RoutingHandler(maid, executor_, public_key_request));
     client_nfs_.reset(new nfs::ClientMaidNfs(routing_handler_->routing(), maid));
     user_storage_.reset(new UserStorage());
   }
 
-  void TearDown() {}
+  void TearDown() {
+    client_nfs_.reset();
+    routing_handler_.reset();
+  }
 
   void MountDrive() {
     user_storage_->MountDrive(*client_nfs_, session_);
@@ -83,6 +86,7 @@ class UserStorageTest : public testing::Test {
 
   maidsafe::test::TestPath test_dir_;
   fs::path mount_dir_;
+  Executor executor_;
   Session session_;
   RoutingHandlerPtr routing_handler_;
   ClientNfsPtr client_nfs_;